@@ -0,0 +1,97 @@
+#include "AsyncExecutor.h"
+
+#include "spdlog/spdlog.h"
+
+#include "database/Exceptions.h"
+
+namespace Database {
+
+AsyncExecutor::AsyncExecutor(ConnectionPool &pool,
+                             const AsyncExecutorOptions &options)
+    : m_pool(pool), m_queueCapacity(options.queueCapacity) {
+  m_workers.reserve(options.workers);
+  for (std::size_t i = 0; i < options.workers; ++i)
+    m_workers.emplace_back([this] { run(); });
+}
+
+AsyncExecutor::~AsyncExecutor() {
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_stopping = true;
+  }
+  m_taskQueued.notify_all();
+  m_taskTaken.notify_all();
+  for (auto &worker : m_workers)
+    worker.join();
+}
+
+auto AsyncExecutor::post(std::function<void()> task) -> void {
+  auto guarded = Task{[task = std::move(task)] {
+    try {
+      task();
+    } catch (const std::exception &e) {
+      logCallbackError(e.what());
+    } catch (...) {
+      logCallbackError("unknown exception");
+    }
+  }};
+  {
+    // Also accepted while stopping: workers drain the queue before exiting.
+    const auto lock = std::lock_guard{m_mutex};
+    m_tasks.push_back(std::move(guarded));
+  }
+  m_taskQueued.notify_one();
+}
+
+auto AsyncExecutor::queued() const -> std::size_t {
+  const auto lock = std::lock_guard{m_mutex};
+  return m_tasks.size();
+}
+
+auto AsyncExecutor::logCallbackError(const char *what) -> void {
+  spdlog::error("AsyncExecutor callback failed: {}", what);
+}
+
+auto AsyncExecutor::acquire(Access access) -> ConnectionPool::Lease {
+  return access == Access::Write ? m_pool.acquireWriter()
+                                 : m_pool.acquireReader();
+}
+
+auto AsyncExecutor::enqueue(Task task, bool wait) -> bool {
+  {
+    auto lock = std::unique_lock{m_mutex};
+    const auto hasRoom = [this] {
+      return m_stopping || m_tasks.size() < m_queueCapacity;
+    };
+    if (wait)
+      m_taskTaken.wait(lock, hasRoom);
+    else if (!hasRoom())
+      return false;
+
+    if (m_stopping)
+      throw DatabaseRuntimeError("AsyncExecutor is stopping");
+    m_tasks.push_back(std::move(task));
+  }
+  m_taskQueued.notify_one();
+  return true;
+}
+
+auto AsyncExecutor::run() -> void {
+  while (true) {
+    auto task = Task{};
+    {
+      auto lock = std::unique_lock{m_mutex};
+      m_taskQueued.wait(lock,
+                        [this] { return m_stopping || !m_tasks.empty(); });
+      if (m_tasks.empty())
+        return;
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+    m_taskTaken.notify_one();
+    // Failures are stored in the task's future.
+    task();
+  }
+}
+
+} // namespace Database
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "database/ConnectionPool.h"
+#include "database/database_export.h"
+
+namespace Database {
+
+// Which pooled connection a task runs on.
+enum class Access { Read, Write };
+
+struct AsyncExecutorOptions {
+  std::size_t workers = 4;
+  // submit() blocks and trySubmit() gives up while this many tasks wait.
+  std::size_t queueCapacity = 1024;
+};
+
+// Runs work on a fixed set of worker threads, each task on a connection
+// leased from a ConnectionPool for its duration: a reader for Access::Read,
+// the single writer for Access::Write. Tasks are callables taking a
+// Connection& and use Query as usual. Failing to lease a connection in time
+// fails the task with LeaseTimeout.
+//
+// The destructor runs every task already queued before joining the workers.
+class DATABASE_EXPORT AsyncExecutor {
+public:
+  AsyncExecutor(ConnectionPool &pool, const AsyncExecutorOptions &options = {});
+  virtual ~AsyncExecutor();
+
+  AsyncExecutor(const AsyncExecutor &) = delete;
+  auto operator=(const AsyncExecutor &) -> AsyncExecutor & = delete;
+
+  template <typename WorkT>
+  using ResultOf = std::invoke_result_t<std::decay_t<WorkT> &, Connection &>;
+
+  // Blocks while the queue is full.
+  template <typename WorkT>
+  auto submit(Access access, WorkT &&work) -> std::future<ResultOf<WorkT>> {
+    auto [task, result] = makeTask(access, std::forward<WorkT>(work));
+    enqueue(std::move(task), true);
+    return std::move(result);
+  }
+
+  // Returns std::nullopt instead of blocking when the queue is full.
+  template <typename WorkT>
+  auto trySubmit(Access access, WorkT &&work)
+      -> std::optional<std::future<ResultOf<WorkT>>> {
+    auto [task, result] = makeTask(access, std::forward<WorkT>(work));
+    if (!enqueue(std::move(task), false))
+      return std::nullopt;
+    return std::move(result);
+  }
+
+  // Calls done with the ready future on the worker thread once the task
+  // finished; done must not block for long and must not throw. Exceptions
+  // escaping it are logged and dropped.
+  template <typename WorkT, typename DoneT>
+  auto submit(Access access, WorkT &&work, DoneT &&done) -> void {
+    auto [task, result] = makeTask(access, std::forward<WorkT>(work));
+    enqueue(
+        [task = std::move(task),
+         result = std::make_shared<decltype(result)>(std::move(result)),
+         done = std::forward<DoneT>(done)]() mutable {
+          task();
+          try {
+            done(std::move(*result));
+          } catch (const std::exception &e) {
+            logCallbackError(e.what());
+          } catch (...) {
+            logCallbackError("unknown exception");
+          }
+        },
+        true);
+  }
+
+  // Runs task on a worker without leasing a connection, for continuations
+  // of work already admitted, such as resuming a coroutine. Never blocks or
+  // fails on a full or stopping queue. Like done, task must not throw.
+  auto post(std::function<void()> task) -> void;
+
+  // Leases a connection as tasks do, for work that spans several tasks.
+  // Throws LeaseTimeout.
+  auto acquire(Access access) -> ConnectionPool::Lease;
+
+  auto queued() const -> std::size_t;
+
+private:
+  using Task = std::function<void()>;
+
+  template <typename WorkT> auto makeTask(Access access, WorkT &&work) {
+    using ResultT = ResultOf<WorkT>;
+    auto task = std::make_shared<std::packaged_task<ResultT()>>(
+        [this, access, work = std::forward<WorkT>(work)]() mutable {
+          auto lease = acquire(access);
+          return work(*lease);
+        });
+    auto result = task->get_future();
+    return std::pair{Task{[task] { (*task)(); }}, std::move(result)};
+  }
+
+  static auto logCallbackError(const char *what) -> void;
+  auto enqueue(Task task, bool wait) -> bool;
+  auto run() -> void;
+
+  ConnectionPool &m_pool;
+  std::size_t m_queueCapacity;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_taskQueued;
+  std::condition_variable m_taskTaken;
+  std::deque<Task> m_tasks;
+  bool m_stopping = false;
+
+  std::vector<std::thread> m_workers;
+};
+
+} // namespace Database
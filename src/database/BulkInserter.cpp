@@ -0,0 +1,82 @@
+#include "BulkInserter.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "spdlog/spdlog.h"
+
+#include "database/Connection.h"
+
+namespace Database {
+
+BulkInserter::BulkInserter(Connection &connection, std::string_view sql,
+                           std::size_t chunkSize)
+    : m_connection(connection), m_query(sql, connection),
+      m_chunkSize(std::max<std::size_t>(chunkSize, 1)),
+      m_uncaughtExceptions(std::uncaught_exceptions()) {}
+
+BulkInserter::~BulkInserter() {
+  if (std::uncaught_exceptions() > m_uncaughtExceptions) {
+    rollback();
+    return;
+  }
+
+  try {
+    finish();
+  } catch (const std::exception &e) {
+    spdlog::error("Bulk insert commit failed: {}", e.what());
+    rollback();
+  }
+}
+
+auto BulkInserter::finish() -> void { commit(); }
+
+auto BulkInserter::stats() const -> BulkInsertStats { return m_stats; }
+
+auto BulkInserter::beginRow() -> void {
+  if (m_stats.rows == 0 && m_rowsInChunk == 0)
+    m_firstRow = std::chrono::steady_clock::now();
+
+  if (m_rowsInChunk == 0 && !m_connection.isInTransaction())
+    m_transaction.emplace(m_connection);
+}
+
+auto BulkInserter::endRow() -> void {
+  m_query.execute();
+  ++m_rowsInChunk;
+
+  if (m_rowsInChunk >= m_chunkSize)
+    commit();
+}
+
+auto BulkInserter::commit() -> void {
+  if (m_rowsInChunk == 0)
+    return;
+
+  if (m_transaction) {
+    m_transaction->commit();
+    m_transaction.reset();
+    ++m_stats.transactions;
+  }
+
+  m_stats.rows += m_rowsInChunk;
+  m_rowsInChunk = 0;
+  m_stats.elapsed = std::chrono::steady_clock::now() - m_firstRow;
+}
+
+auto BulkInserter::rollback() -> void {
+  m_query.reset();
+  // Rows inserted into the caller's transaction are the caller's to undo.
+  if (!m_transaction)
+    return;
+
+  try {
+    m_transaction->rollback();
+  } catch (const std::exception &e) {
+    spdlog::error("Bulk insert rollback failed: {}", e.what());
+  }
+  m_transaction.reset();
+  m_rowsInChunk = 0;
+}
+
+} // namespace Database
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "database/Connection_fwd.h"
+#include "database/Query.h"
+#include "database/RowMapping.h"
+#include "database/Transaction.h"
+#include "database/database_export.h"
+
+namespace Database {
+
+struct BulkInsertStats {
+  std::uint64_t rows = 0;
+  std::uint64_t transactions = 0;
+  // From the first inserted row to the last commit.
+  std::chrono::nanoseconds elapsed{};
+
+  auto rowsPerSecond() const -> double {
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? rows / seconds : 0.0;
+  }
+};
+
+// Inserts rows through one prepared statement, committing every chunkSize
+// rows in a single transaction. Values are bound positionally: the i-th value
+// of a row goes to the i-th parameter of sql, and struct rows described by a
+// RowMapping bind each field to the parameter of the same name. When the
+// connection already is in a transaction the rows join it and nothing is
+// committed here.
+//
+// A failing row rolls back the chunk it belongs to; earlier chunks stay
+// committed.
+class DATABASE_EXPORT BulkInserter {
+public:
+  static constexpr std::size_t defaultChunkSize = 10000;
+
+  BulkInserter(Connection &connection, std::string_view sql,
+               std::size_t chunkSize = defaultChunkSize);
+  // Commits the pending chunk, or rolls it back when the scope is left by an
+  // exception; use finish() to see commit errors.
+  virtual ~BulkInserter();
+
+  template <typename... ValueT> auto insert(ValueT &&...values) -> void {
+    beginRow();
+    try {
+      bindRow(std::index_sequence_for<ValueT...>{},
+              std::forward<ValueT>(values)...);
+      endRow();
+    } catch (...) {
+      rollback();
+      throw;
+    }
+  }
+
+  // Inserts a tuple-like row (std::tuple, std::pair, std::array).
+  template <typename TupleT> auto insertTuple(TupleT &&row) -> void {
+    std::apply(
+        [this](auto &&...values) {
+          insert(std::forward<decltype(values)>(values)...);
+        },
+        std::forward<TupleT>(row));
+  }
+
+  // Inserts a range of tuple-like rows or of structs with a RowMapping.
+  template <typename RangeT> auto insertMany(const RangeT &rows) -> void {
+    using RowT = std::decay_t<decltype(*std::begin(rows))>;
+    if constexpr (detail::hasRowMapping<RowT>) {
+      constexpr auto fields = std::make_index_sequence<
+          RowMapper<RowT>::fieldCount>{};
+      const auto parameters = parametersOf<RowT>(fields);
+      for (const auto &row : rows)
+        insertMapped(row, parameters, fields);
+    } else {
+      for (const auto &row : rows)
+        insertTuple(row);
+    }
+  }
+
+  // Commits the pending chunk.
+  auto finish() -> void;
+
+  auto stats() const -> BulkInsertStats;
+
+private:
+  template <std::size_t... Idx, typename... ValueT>
+  auto bindRow(std::index_sequence<Idx...>, ValueT &&...values) -> void {
+    (m_query.set(Parameter{static_cast<int>(Idx) + 1},
+                 std::forward<ValueT>(values)),
+     ...);
+  }
+
+  // Parameters named after the fields of a RowMapping, looked up once.
+  template <typename RowT, std::size_t... Idx>
+  auto parametersOf(std::index_sequence<Idx...>) const
+      -> std::array<Parameter, sizeof...(Idx)> {
+    return {m_query.parameter(std::get<Idx>(RowMapping<RowT>::fields).name)...};
+  }
+
+  template <typename RowT, std::size_t... Idx>
+  auto insertMapped(const RowT &row,
+                    const std::array<Parameter, sizeof...(Idx)> &parameters,
+                    std::index_sequence<Idx...>) -> void {
+    beginRow();
+    try {
+      (m_query.set(parameters[Idx],
+                   row.*std::get<Idx>(RowMapping<RowT>::fields).member),
+       ...);
+      endRow();
+    } catch (...) {
+      rollback();
+      throw;
+    }
+  }
+
+  auto beginRow() -> void;
+  auto endRow() -> void;
+  auto commit() -> void;
+  auto rollback() -> void;
+
+  Connection &m_connection;
+  Query m_query;
+  std::size_t m_chunkSize;
+  std::size_t m_rowsInChunk = 0;
+  int m_uncaughtExceptions;
+  std::optional<Transaction> m_transaction;
+  std::chrono::steady_clock::time_point m_firstRow;
+  BulkInsertStats m_stats;
+};
+
+} // namespace Database
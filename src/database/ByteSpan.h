@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+namespace Database {
+
+// Read-only view of contiguous bytes, standing in for
+// std::span<const std::byte> while the library builds as C++17.
+class ByteSpan {
+public:
+  constexpr ByteSpan() = default;
+  constexpr ByteSpan(const std::byte *data, std::size_t size)
+      : m_data(data), m_size(size) {}
+
+  constexpr auto data() const -> const std::byte * { return m_data; }
+  constexpr auto size() const -> std::size_t { return m_size; }
+  constexpr auto empty() const -> bool { return m_size == 0; }
+
+  constexpr auto begin() const -> const std::byte * { return m_data; }
+  constexpr auto end() const -> const std::byte * { return m_data + m_size; }
+
+  constexpr auto operator[](std::size_t idx) const -> const std::byte & {
+    return m_data[idx];
+  }
+
+#if defined(__cpp_lib_span)
+  constexpr operator std::span<const std::byte>() const {
+    return {m_data, m_size};
+  }
+#endif
+
+private:
+  const std::byte *m_data = nullptr;
+  std::size_t m_size = 0;
+};
+
+} // namespace Database
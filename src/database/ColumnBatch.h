@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "database/ByteSpan.h"
+#include "database/Query.h"
+#include "database/StatementSpec.h"
+
+namespace Database {
+
+// Contiguous values of one result column over a batch of rows. Integer and
+// floating point columns are plain arrays; see the specializations for
+// text, blobs and nullable columns.
+template <typename ValueT> class ColumnBuffer {
+  static_assert(std::is_arithmetic_v<ValueT>,
+                "Column buffers hold numbers, std::string, "
+                "std::vector<std::byte> or std::optional of those");
+
+public:
+  auto size() const -> std::size_t { return m_values.size(); }
+  auto operator[](std::size_t row) const -> ValueT { return m_values[row]; }
+  auto data() const -> const ValueT * { return m_values.data(); }
+
+  auto append(Query &query, Column column) -> void {
+    m_values.push_back(query.get<ValueT>(column));
+  }
+  auto appendEmpty() -> void { m_values.push_back(ValueT{}); }
+  auto reserve(std::size_t rows) -> void { m_values.reserve(rows); }
+  auto clear() -> void { m_values.clear(); }
+
+private:
+  std::vector<ValueT> m_values;
+};
+
+namespace detail {
+
+// Values stored back to back in one buffer; value i spans
+// [offsets[i], offsets[i + 1]).
+template <typename ByteT, typename ViewT, typename ReadT>
+class VariableLengthColumn {
+public:
+  auto size() const -> std::size_t { return m_offsets.size() - 1; }
+  auto operator[](std::size_t row) const -> ViewT {
+    return ViewT{m_bytes.data() + m_offsets[row],
+                 m_offsets[row + 1] - m_offsets[row]};
+  }
+  auto bytes() const -> const std::vector<ByteT> & { return m_bytes; }
+  auto offsets() const -> const std::vector<std::size_t> & {
+    return m_offsets;
+  }
+
+  auto append(Query &query, Column column) -> void {
+    const auto value = query.get<ReadT>(column);
+    m_bytes.insert(m_bytes.end(), value.begin(), value.end());
+    m_offsets.push_back(m_bytes.size());
+  }
+  auto appendEmpty() -> void { m_offsets.push_back(m_bytes.size()); }
+  auto reserve(std::size_t rows) -> void { m_offsets.reserve(rows + 1); }
+  auto clear() -> void {
+    m_bytes.clear();
+    m_offsets.assign(1, 0);
+  }
+
+private:
+  std::vector<ByteT> m_bytes;
+  std::vector<std::size_t> m_offsets{0};
+};
+
+} // namespace detail
+
+// Text as one character buffer plus row offsets.
+template <>
+class ColumnBuffer<std::string>
+    : public detail::VariableLengthColumn<char, std::string_view,
+                                          std::string_view> {};
+
+// Blobs as one byte buffer plus row offsets.
+template <>
+class ColumnBuffer<std::vector<std::byte>>
+    : public detail::VariableLengthColumn<std::byte, ByteSpan, ByteSpan> {};
+
+// A nullable column: the values of ValueT (default or empty for NULL) plus
+// a validity mask with 1 for every non-NULL row.
+template <typename ValueT> class ColumnBuffer<std::optional<ValueT>> {
+public:
+  auto size() const -> std::size_t { return m_values.size(); }
+  auto values() const -> const ColumnBuffer<ValueT> & { return m_values; }
+  auto valid() const -> const std::vector<std::uint8_t> & { return m_valid; }
+  auto isNull(std::size_t row) const -> bool { return !m_valid[row]; }
+
+  auto append(Query &query, Column column) -> void {
+    const auto isValid = !query.isNull(column);
+    if (isValid)
+      m_values.append(query, column);
+    else
+      m_values.appendEmpty();
+    m_valid.push_back(isValid);
+  }
+  auto appendEmpty() -> void {
+    m_values.appendEmpty();
+    m_valid.push_back(0);
+  }
+  auto reserve(std::size_t rows) -> void {
+    m_values.reserve(rows);
+    m_valid.reserve(rows);
+  }
+  auto clear() -> void {
+    m_values.clear();
+    m_valid.clear();
+  }
+
+private:
+  ColumnBuffer<ValueT> m_values;
+  std::vector<std::uint8_t> m_valid;
+};
+
+// Struct-of-arrays buffers for columns 0, 1, ... of a result, filled by
+// Query::fetchColumns. Reusing a batch across calls keeps its capacity.
+template <typename... ValueT> class ColumnBatch {
+public:
+  template <std::size_t Index>
+  using BufferAt =
+      ColumnBuffer<std::tuple_element_t<Index, std::tuple<ValueT...>>>;
+
+  auto rows() const -> std::size_t { return m_rows; }
+  auto empty() const -> bool { return m_rows == 0; }
+
+  template <std::size_t Index> auto column() const -> const BufferAt<Index> & {
+    return std::get<Index>(m_columns);
+  }
+
+  auto clear() -> void {
+    std::apply([](auto &...columns) { (columns.clear(), ...); }, m_columns);
+    m_rows = 0;
+  }
+
+  auto reserve(std::size_t rows) -> void {
+    std::apply([rows](auto &...columns) { (columns.reserve(rows), ...); },
+               m_columns);
+  }
+
+  // Appends the current row of query.
+  auto append(Query &query) -> void {
+    appendRow(query, std::index_sequence_for<ValueT...>{});
+    ++m_rows;
+  }
+
+private:
+  template <std::size_t... Indices>
+  auto appendRow(Query &query, std::index_sequence<Indices...>) -> void {
+    (std::get<Indices>(m_columns)
+         .append(query, Column{static_cast<int>(Indices)}),
+     ...);
+  }
+
+  std::tuple<ColumnBuffer<ValueT>...> m_columns;
+  std::size_t m_rows = 0;
+};
+
+template <typename... ValueT>
+auto Query::fetchColumns(std::size_t batchSize) -> ColumnBatch<ValueT...> {
+  auto batch = ColumnBatch<ValueT...>{};
+  fetchColumns(batch, batchSize);
+  return batch;
+}
+
+template <typename... ValueT>
+auto Query::fetchColumns(ColumnBatch<ValueT...> &batch, std::size_t batchSize)
+    -> bool {
+  batch.clear();
+  batch.reserve(batchSize);
+  while (batch.rows() < batchSize && next())
+    batch.append(*this);
+  return !batch.empty();
+}
+
+} // namespace Database
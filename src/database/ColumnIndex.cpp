@@ -0,0 +1,77 @@
+#include "ColumnIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+constexpr auto toLowerAscii(char c) -> char {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Compares an already lowercased column name with a name as typed by the
+// caller.
+auto lessThanLowered(std::string_view lowered, std::string_view name) -> bool {
+  const auto length = std::min(lowered.size(), name.size());
+  for (std::size_t i = 0; i < length; ++i) {
+    const auto rhs = toLowerAscii(name[i]);
+    if (lowered[i] != rhs)
+      return static_cast<unsigned char>(lowered[i]) <
+             static_cast<unsigned char>(rhs);
+  }
+  return lowered.size() < name.size();
+}
+
+auto equalLowered(std::string_view lowered, std::string_view name) -> bool {
+  return lowered.size() == name.size() &&
+         std::equal(begin(lowered), end(lowered), begin(name),
+                    [](char lhs, char rhs) { return lhs == toLowerAscii(rhs); });
+}
+
+} // namespace
+
+namespace Database::detail {
+
+ColumnIndex::ColumnIndex(sqlite3_stmt *statement,
+                         std::pmr::memory_resource *resource)
+    : m_names(resource), m_entries(resource) {
+  const auto columnCount = sqlite3_column_count(statement);
+  m_entries.reserve(columnCount);
+
+  for (auto i = 0; i < columnCount; ++i) {
+    const auto name = sqlite3_column_name(statement, i);
+    const auto length = std::strlen(name);
+
+    m_entries.push_back({static_cast<std::uint32_t>(m_names.size()),
+                         static_cast<std::uint32_t>(length), i});
+    std::transform(name, name + length, std::back_inserter(m_names),
+                   toLowerAscii);
+  }
+
+  // Stable so that duplicated names resolve to the leftmost column.
+  std::stable_sort(begin(m_entries), end(m_entries),
+                   [this](const Entry &lhs, const Entry &rhs) {
+                     return nameOf(lhs) < nameOf(rhs);
+                   });
+}
+
+auto ColumnIndex::find(std::string_view name) const -> int {
+  const auto it = std::lower_bound(
+      begin(m_entries), end(m_entries), name,
+      [this](const Entry &entry, std::string_view value) {
+        return lessThanLowered(nameOf(entry), value);
+      });
+
+  if (it == end(m_entries) || !equalLowered(nameOf(*it), name))
+    return npos;
+  return it->column;
+}
+
+auto ColumnIndex::size() const -> std::size_t { return m_entries.size(); }
+
+auto ColumnIndex::nameOf(const Entry &entry) const -> std::string_view {
+  return std::string_view{m_names}.substr(entry.offset, entry.length);
+}
+
+} // namespace Database::detail
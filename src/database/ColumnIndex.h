@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sqlite3.h"
+
+namespace Database::detail {
+
+// Result column names of a prepared statement, resolved once and kept in a
+// single buffer sorted for binary search. Names match case-insensitively.
+// Both allocations come from the given memory resource.
+class ColumnIndex {
+public:
+  static constexpr int npos = -1;
+
+  ColumnIndex() = default;
+  explicit ColumnIndex(sqlite3_stmt *statement,
+                       std::pmr::memory_resource *resource =
+                           std::pmr::get_default_resource());
+
+  auto find(std::string_view name) const -> int;
+  auto size() const -> std::size_t;
+
+private:
+  struct Entry {
+    std::uint32_t offset;
+    std::uint32_t length;
+    int column;
+  };
+
+  auto nameOf(const Entry &entry) const -> std::string_view;
+
+  std::pmr::string m_names;
+  std::pmr::vector<Entry> m_entries;
+};
+
+} // namespace Database::detail
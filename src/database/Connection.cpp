@@ -1,21 +1,26 @@
 #include "Connection.h"
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <string_view>
 
 #include "database/Exceptions.h"
-#include "spdlog/fmt/bundled/core.h"
+#include "database/Query.h"
+#include "spdlog/fmt/fmt.h"
 #include "sqlite3.h"
 
 namespace {
 
+constexpr auto defaultOpenFlags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+
 auto createConnection(std::string_view connectionString,
-                      const int customFlags = 0) -> sqlite3 * {
-  const auto flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | customFlags;
+                      const int flags = defaultOpenFlags) -> sqlite3 * {
   sqlite3 *connection;
   const auto result =
       sqlite3_open_v2(connectionString.data(), &connection, flags, nullptr);
   if (result != SQLITE_OK) {
+    sqlite3_close(connection);
     throw Database::ErrorOpeningDatabase(
         fmt::format("Cannot open database '{}': error code {:x}",
                     connectionString, result));
@@ -23,9 +28,110 @@ auto createConnection(std::string_view connectionString,
   return connection;
 }
 
+auto journalModeName(Database::JournalMode mode) -> std::string_view {
+  using Database::JournalMode;
+  switch (mode) {
+  case JournalMode::Delete:
+    return "delete";
+  case JournalMode::Truncate:
+    return "truncate";
+  case JournalMode::Persist:
+    return "persist";
+  case JournalMode::Memory:
+    return "memory";
+  case JournalMode::Wal:
+    return "wal";
+  case JournalMode::Off:
+    break;
+  }
+  return "off";
+}
+
+// Runs "pragma name = value".
+template <typename ValueT>
+auto setPragma(Database::Connection &connection, std::string_view name,
+               const ValueT &value) -> void {
+  auto query = Database::Query{fmt::format("pragma {} = {}", name, value),
+                               connection, Database::QueryOptions{false}};
+  while (query.next()) {
+  }
+}
+
+// Runs "pragma name = value" and reads the setting back, which must satisfy
+// accepted(setting, value).
+template <typename ValueT, typename AcceptedT = std::equal_to<>>
+auto applyPragma(Database::Connection &connection, std::string_view name,
+                 const ValueT &value, AcceptedT accepted = {}) -> void {
+  setPragma(connection, name, value);
+
+  const auto options = Database::QueryOptions{false};
+  auto query =
+      Database::Query{fmt::format("pragma {}", name), connection, options};
+  if (!query.next() ||
+      !accepted(query.get<ValueT>(Database::Column{0}), value))
+    throw Database::ErrorOpeningDatabase(
+        fmt::format("Cannot set pragma {} to {}", name, value));
+}
+
+auto openFlags(const Database::ConnectionOptions &options) -> int {
+  auto flags = options.readOnly ? SQLITE_OPEN_READONLY : defaultOpenFlags;
+  if (options.noMutex)
+    flags |= SQLITE_OPEN_NOMUTEX;
+  return flags;
+}
+
+auto applyLookaside(sqlite3 *connection,
+                    const Database::LookasideOptions &lookaside) -> void {
+  const auto result =
+      sqlite3_db_config(connection, SQLITE_DBCONFIG_LOOKASIDE,
+                        lookaside.buffer, lookaside.slotSize,
+                        lookaside.slotCount);
+  if (result != SQLITE_OK)
+    throw Database::ErrorOpeningDatabase(fmt::format(
+        "Cannot configure lookaside of {} slots of {} bytes: error code {:x}",
+        lookaside.slotCount, lookaside.slotSize, result));
+}
+
+auto applyOptions(Database::Connection &connection,
+                  const Database::ConnectionOptions &options) -> void {
+  // Before journal_mode: WAL fixes the page size of the database. Not read
+  // back, since an existing database keeps its page size.
+  if (options.pageSize)
+    setPragma<int64_t>(connection, "page_size", *options.pageSize);
+  if (options.journalMode)
+    applyPragma(connection, "journal_mode",
+                std::string{journalModeName(*options.journalMode)});
+  if (options.synchronous)
+    applyPragma<int64_t>(connection, "synchronous",
+                         static_cast<int64_t>(*options.synchronous));
+  if (options.cacheSize)
+    applyPragma<int64_t>(connection, "cache_size", *options.cacheSize);
+  // SQLite caps mmap_size at SQLITE_MAX_MMAP_SIZE.
+  if (options.mmapSize)
+    applyPragma<int64_t>(connection, "mmap_size", *options.mmapSize,
+                         std::less_equal<>{});
+  if (options.tempStore)
+    applyPragma<int64_t>(connection, "temp_store",
+                         static_cast<int64_t>(*options.tempStore));
+  if (options.busyTimeout)
+    applyPragma<int64_t>(connection, "busy_timeout",
+                         options.busyTimeout->count());
+}
+
+// Current value of a sqlite3_db_status counter, or its highwater mark.
+auto dbStatus(sqlite3 *connection, int op, bool highwater = false)
+    -> std::int64_t {
+  auto current = 0;
+  auto highest = 0;
+  sqlite3_db_status(connection, op, &current, &highest, 0);
+  return highwater ? highest : current;
+}
+
 struct connection_deleter {
+  // Closes once the last statement is finalized, including those of Queries
+  // that outlive their Connection.
   auto operator()(sqlite3 *ptr) -> void {
-    [[maybe_unused]] const auto rc = sqlite3_close(ptr);
+    [[maybe_unused]] const auto rc = sqlite3_close_v2(ptr);
   }
 };
 
@@ -35,39 +141,125 @@ namespace Database {
 
 class Connection::Impl {
 public:
-  Impl(std::string_view connectionString);
+  Impl(std::string_view connectionString, int flags);
   Impl();
 
   virtual ~Impl();
 
   sqlite3 *getRawConnection() const;
+  detail::StatementCache &getStatementCache();
+  auto setSlowQueryLog(std::unique_ptr<detail::SlowQueryLog> log) -> void;
 
 private:
+  // Detached by the destructor: the connection stays open, tracing, for as
+  // long as Queries that outlive the Connection hold statements of it.
+  std::unique_ptr<detail::SlowQueryLog> m_slowQueryLog;
   std::unique_ptr<sqlite3, connection_deleter> m_dbConnection;
+  // Declared after the connection so cached statements are finalized first.
+  detail::StatementCache m_statementCache;
 };
 
-Connection::Impl::~Impl() {}
+Connection::Impl::~Impl() {
+  if (m_slowQueryLog)
+    detail::SlowQueryLog::detach(getRawConnection());
+}
 
-Connection::Impl::Impl(std::string_view connectionString)
-    : m_dbConnection(std::move(createConnection(connectionString))) {}
+Connection::Impl::Impl(std::string_view connectionString, int flags)
+    : m_dbConnection(std::move(createConnection(connectionString, flags))) {}
 
 Connection::Impl::Impl()
-    : m_dbConnection(
-          std::move(createConnection(":memory:", SQLITE_OPEN_MEMORY))) {}
+    : m_dbConnection(std::move(createConnection(
+          ":memory:", defaultOpenFlags | SQLITE_OPEN_MEMORY))) {}
 
 auto Connection::Impl::getRawConnection() const -> sqlite3 * {
   return m_dbConnection.get();
 }
 
+auto Connection::Impl::getStatementCache() -> detail::StatementCache & {
+  return m_statementCache;
+}
+
+auto Connection::Impl::setSlowQueryLog(
+    std::unique_ptr<detail::SlowQueryLog> log) -> void {
+  if (log)
+    log->attach(getRawConnection());
+  else
+    detail::SlowQueryLog::detach(getRawConnection());
+  // The previous log is only released once SQLite stopped calling it.
+  m_slowQueryLog = std::move(log);
+}
+
 Connection::Connection() : m_impl(std::make_unique<Impl>()) {}
 
 Connection::~Connection() {}
 
 Connection::Connection(std::string_view connectionString)
-    : m_impl(std::make_unique<Impl>(connectionString)) {}
+    : m_impl(std::make_unique<Impl>(connectionString, defaultOpenFlags)) {}
+
+Connection::Connection(std::string_view connectionString,
+                       const ConnectionOptions &options)
+    : m_impl(std::make_unique<Impl>(connectionString, openFlags(options))) {
+  // Only possible while the connection holds no lookaside memory, i.e.
+  // before its first statement.
+  if (options.lookaside)
+    applyLookaside(getRawConnection(), *options.lookaside);
+  applyOptions(*this, options);
+}
 
 auto Connection::getRawConnection() const -> sqlite3 * {
   return m_impl->getRawConnection();
 }
 
+auto Connection::getStatementCache() -> detail::StatementCache & {
+  return m_impl->getStatementCache();
+}
+
+auto Connection::changes() const -> std::int64_t {
+  return sqlite3_changes64(getRawConnection());
+}
+
+auto Connection::isInTransaction() const -> bool {
+  return !sqlite3_get_autocommit(getRawConnection());
+}
+
+auto Connection::setStatementCacheCapacity(std::size_t capacity) -> void {
+  m_impl->getStatementCache().setCapacity(capacity);
+}
+
+auto Connection::statementCacheStats() const -> StatementCacheStats {
+  return m_impl->getStatementCache().stats();
+}
+
+auto Connection::stats() const -> ConnectionStats {
+  const auto db = getRawConnection();
+  auto stats = ConnectionStats{};
+  stats.cacheUsed = dbStatus(db, SQLITE_DBSTATUS_CACHE_USED);
+  stats.cacheUsedShared = dbStatus(db, SQLITE_DBSTATUS_CACHE_USED_SHARED);
+  stats.cacheHits = dbStatus(db, SQLITE_DBSTATUS_CACHE_HIT);
+  stats.cacheMisses = dbStatus(db, SQLITE_DBSTATUS_CACHE_MISS);
+  stats.cacheWrites = dbStatus(db, SQLITE_DBSTATUS_CACHE_WRITE);
+  stats.cacheSpills = dbStatus(db, SQLITE_DBSTATUS_CACHE_SPILL);
+  stats.lookasideUsed = dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_USED);
+  stats.lookasideHighwater =
+      dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_USED, true);
+  // The hit and miss counters only have a highwater value.
+  stats.lookasideHits = dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_HIT, true);
+  stats.lookasideMissesSize =
+      dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, true);
+  stats.lookasideMissesFull =
+      dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, true);
+  stats.schemaUsed = dbStatus(db, SQLITE_DBSTATUS_SCHEMA_USED);
+  stats.statementUsed = dbStatus(db, SQLITE_DBSTATUS_STMT_USED);
+  stats.process = memoryStats();
+  return stats;
+}
+
+auto Connection::setSlowQueryLog(const SlowQueryLogOptions &options) -> void {
+  m_impl->setSlowQueryLog(std::make_unique<detail::SlowQueryLog>(options));
+}
+
+auto Connection::disableSlowQueryLog() -> void {
+  m_impl->setSlowQueryLog(nullptr);
+}
+
 } // namespace Database
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string_view>
 
 #include "sqlite3.h"
 
+#include "database/ConnectionOptions.h"
+#include "database/ConnectionStats.h"
 #include "database/Query_fwd.h"
+#include "database/SlowQueryLog.h"
+#include "database/StatementCache.h"
 #include "database/database_export.h"
 
 namespace Database {
@@ -15,6 +21,29 @@ public:
   Connection();
   virtual ~Connection();
   explicit Connection(std::string_view connectionString);
+  // Throws ErrorOpeningDatabase when an option cannot be applied, e.g. WAL
+  // on an in-memory database.
+  Connection(std::string_view connectionString,
+             const ConnectionOptions &options);
+
+  // Rows modified by the most recent INSERT, UPDATE or DELETE.
+  auto changes() const -> std::int64_t;
+
+  // True between BEGIN and COMMIT/ROLLBACK.
+  auto isInTransaction() const -> bool;
+
+  // Upper bound of prepared statements kept for reuse; 0 disables caching.
+  auto setStatementCacheCapacity(std::size_t capacity) -> void;
+  auto statementCacheStats() const -> StatementCacheStats;
+
+  // Memory and cache figures of this connection, plus the process wide
+  // allocator state. Cheap enough to poll; see ConnectionStatsSampler.
+  auto stats() const -> ConnectionStats;
+
+  // Logs statements of this connection slower than a threshold (and a
+  // sample of the rest) through sqlite3_trace_v2. Replaces a previous log.
+  auto setSlowQueryLog(const SlowQueryLogOptions &options) -> void;
+  auto disableSlowQueryLog() -> void;
 
 private:
   class Impl;
@@ -23,6 +52,7 @@ private:
   friend class Query;
 
   auto getRawConnection() const -> sqlite3 *;
+  auto getStatementCache() -> detail::StatementCache &;
 
   std::unique_ptr<Impl> m_impl;
 };
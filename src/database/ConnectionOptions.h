@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace Database {
+
+enum class JournalMode { Delete, Truncate, Persist, Memory, Wal, Off };
+
+enum class Synchronous { Off, Normal, Full, Extra };
+
+enum class TempStore { Default, File, Memory };
+
+// Lookaside allocator of one connection (SQLITE_DBCONFIG_LOOKASIDE):
+// slotCount slots of slotSize bytes serving small, short-lived
+// allocations without the global allocator. A caller supplied buffer must
+// hold slotSize * slotCount bytes, be 8 byte aligned and outlive the
+// connection; without one SQLite allocates it. slotCount 0 disables
+// lookaside.
+struct LookasideOptions {
+  int slotSize = 1200;
+  int slotCount = 100;
+  void *buffer = nullptr;
+};
+
+// Settings applied right after a connection is opened and read back to
+// verify SQLite accepted them. Unset members keep SQLite's defaults.
+struct ConnectionOptions {
+  // SQLITE_OPEN_READONLY instead of READWRITE | CREATE.
+  bool readOnly = false;
+  // SQLITE_OPEN_NOMUTEX: SQLite does not serialize calls on the connection,
+  // so it must never be used by two threads at once.
+  bool noMutex = false;
+
+  std::optional<JournalMode> journalMode;
+  std::optional<Synchronous> synchronous;
+  // Bytes of the database file to memory map; capped by SQLITE_MAX_MMAP_SIZE.
+  std::optional<std::int64_t> mmapSize;
+  // Page cache size: pages when positive, KiB when negative.
+  std::optional<std::int64_t> cacheSize;
+  std::optional<TempStore> tempStore;
+  // Only takes effect before the database file gets its first table; an
+  // existing database keeps its page size.
+  std::optional<int> pageSize;
+  std::optional<std::chrono::milliseconds> busyTimeout;
+  std::optional<LookasideOptions> lookaside;
+
+  // WAL with synchronous=NORMAL, 256 MiB mmap, 64 MiB page cache, in-memory
+  // temp tables and a 5 s busy timeout: a profile for concurrent readers and
+  // a single writer on a file database.
+  static auto highThroughput() -> ConnectionOptions {
+    auto options = ConnectionOptions{};
+    options.journalMode = JournalMode::Wal;
+    options.synchronous = Synchronous::Normal;
+    options.mmapSize = 256ll * 1024 * 1024;
+    options.cacheSize = -64 * 1024;
+    options.tempStore = TempStore::Memory;
+    options.busyTimeout = std::chrono::seconds{5};
+    return options;
+  }
+};
+
+} // namespace Database
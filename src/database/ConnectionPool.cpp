@@ -0,0 +1,130 @@
+#include "ConnectionPool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "spdlog/fmt/fmt.h"
+
+#include "database/Exceptions.h"
+
+namespace {
+
+auto recordWait(std::chrono::nanoseconds wait, std::chrono::nanoseconds &total,
+                std::chrono::nanoseconds &max) -> void {
+  total += wait;
+  max = std::max(max, wait);
+}
+
+} // namespace
+
+namespace Database {
+
+ConnectionPool::ConnectionPool(std::string_view path,
+                               const ConnectionPoolOptions &options)
+    : m_leaseTimeout(options.leaseTimeout),
+      m_writer(std::make_unique<Connection>(path, options.writerOptions)) {
+  auto readerOptions = options.readerOptions;
+  readerOptions.readOnly = true;
+  readerOptions.noMutex = true;
+
+  m_readers.reserve(options.readers);
+  m_idleReaders.reserve(options.readers);
+  for (std::size_t i = 0; i < options.readers; ++i) {
+    m_readers.push_back(std::make_unique<Connection>(path, readerOptions));
+    m_idleReaders.push_back(m_readers.back().get());
+  }
+}
+
+ConnectionPool::~ConnectionPool() {}
+
+auto ConnectionPool::acquireReader() -> Lease {
+  return acquireReader(m_leaseTimeout);
+}
+
+auto ConnectionPool::acquireReader(std::chrono::milliseconds timeout)
+    -> Lease {
+  const auto start = std::chrono::steady_clock::now();
+  auto lock = std::unique_lock{m_mutex};
+  if (!m_readerReleased.wait_for(lock, timeout,
+                                 [this] { return !m_idleReaders.empty(); })) {
+    ++m_metrics.timeouts;
+    throw LeaseTimeout(
+        fmt::format("No reader connection free within {} ms", timeout.count()));
+  }
+
+  const auto connection = m_idleReaders.back();
+  m_idleReaders.pop_back();
+  ++m_metrics.readerLeases;
+  recordWait(std::chrono::steady_clock::now() - start,
+             m_metrics.readerWaitTotal, m_metrics.readerWaitMax);
+  return Lease{*this, *connection};
+}
+
+auto ConnectionPool::acquireWriter() -> Lease {
+  return acquireWriter(m_leaseTimeout);
+}
+
+auto ConnectionPool::acquireWriter(std::chrono::milliseconds timeout)
+    -> Lease {
+  const auto start = std::chrono::steady_clock::now();
+  auto lock = std::unique_lock{m_mutex};
+  if (!m_writerReleased.wait_for(lock, timeout,
+                                 [this] { return !m_writerLeased; })) {
+    ++m_metrics.timeouts;
+    throw LeaseTimeout(fmt::format("Writer connection not free within {} ms",
+                                   timeout.count()));
+  }
+
+  m_writerLeased = true;
+  ++m_metrics.writerLeases;
+  recordWait(std::chrono::steady_clock::now() - start,
+             m_metrics.writerWaitTotal, m_metrics.writerWaitMax);
+  return Lease{*this, *m_writer};
+}
+
+auto ConnectionPool::metrics() const -> ConnectionPoolMetrics {
+  const auto lock = std::lock_guard{m_mutex};
+  auto metrics = m_metrics;
+  metrics.idleReaders = m_idleReaders.size();
+  return metrics;
+}
+
+auto ConnectionPool::release(Connection *connection) -> void {
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (connection == m_writer.get())
+      m_writerLeased = false;
+    else
+      m_idleReaders.push_back(connection);
+  }
+
+  if (connection == m_writer.get())
+    m_writerReleased.notify_one();
+  else
+    m_readerReleased.notify_one();
+}
+
+ConnectionPool::Lease::Lease(ConnectionPool &pool, Connection &connection)
+    : m_pool(&pool), m_connection(&connection) {}
+
+ConnectionPool::Lease::Lease(Lease &&other) noexcept
+    : m_pool(std::exchange(other.m_pool, nullptr)),
+      m_connection(std::exchange(other.m_connection, nullptr)) {}
+
+auto ConnectionPool::Lease::operator=(Lease &&other) noexcept -> Lease & {
+  if (this != &other) {
+    release();
+    m_pool = std::exchange(other.m_pool, nullptr);
+    m_connection = std::exchange(other.m_connection, nullptr);
+  }
+  return *this;
+}
+
+ConnectionPool::Lease::~Lease() { release(); }
+
+auto ConnectionPool::Lease::release() -> void {
+  if (m_pool)
+    std::exchange(m_pool, nullptr)->release(m_connection);
+}
+
+} // namespace Database
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "database/Connection.h"
+#include "database/ConnectionOptions.h"
+#include "database/database_export.h"
+
+namespace Database {
+
+struct ConnectionPoolOptions {
+  std::size_t readers = 4;
+  std::chrono::milliseconds leaseTimeout{5000};
+  // Applied to the single read-write connection, which also creates the
+  // database and switches it to WAL.
+  ConnectionOptions writerOptions = ConnectionOptions::highThroughput();
+  // Applied to every reader; readOnly and noMutex are always forced on.
+  ConnectionOptions readerOptions = defaultReaderOptions();
+
+  static auto defaultReaderOptions() -> ConnectionOptions {
+    auto options = ConnectionOptions{};
+    options.mmapSize = 256ll * 1024 * 1024;
+    options.cacheSize = -16 * 1024;
+    options.tempStore = TempStore::Memory;
+    options.busyTimeout = std::chrono::seconds{5};
+    return options;
+  }
+};
+
+struct ConnectionPoolMetrics {
+  std::uint64_t readerLeases = 0;
+  std::uint64_t writerLeases = 0;
+  std::uint64_t timeouts = 0;
+  std::chrono::nanoseconds readerWaitTotal{};
+  std::chrono::nanoseconds readerWaitMax{};
+  std::chrono::nanoseconds writerWaitTotal{};
+  std::chrono::nanoseconds writerWaitMax{};
+  std::size_t idleReaders = 0;
+};
+
+// Read-only connections (SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX) leased
+// to one thread at a time, plus a single writer connection through which all
+// writes are serialized. Meant for a WAL database file, where readers run in
+// parallel with the writer. Leases must be returned before the pool is
+// destroyed.
+class DATABASE_EXPORT ConnectionPool {
+public:
+  class Lease;
+
+  ConnectionPool(std::string_view path,
+                 const ConnectionPoolOptions &options = {});
+  virtual ~ConnectionPool();
+
+  ConnectionPool(const ConnectionPool &) = delete;
+  auto operator=(const ConnectionPool &) -> ConnectionPool & = delete;
+
+  // Both throw LeaseTimeout when no connection frees up in time.
+  auto acquireReader() -> Lease;
+  auto acquireReader(std::chrono::milliseconds timeout) -> Lease;
+  auto acquireWriter() -> Lease;
+  auto acquireWriter(std::chrono::milliseconds timeout) -> Lease;
+
+  auto metrics() const -> ConnectionPoolMetrics;
+
+private:
+  auto release(Connection *connection) -> void;
+
+  std::chrono::milliseconds m_leaseTimeout;
+  std::unique_ptr<Connection> m_writer;
+  std::vector<std::unique_ptr<Connection>> m_readers;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_readerReleased;
+  std::condition_variable m_writerReleased;
+  std::vector<Connection *> m_idleReaders;
+  bool m_writerLeased = false;
+  ConnectionPoolMetrics m_metrics;
+};
+
+class DATABASE_EXPORT ConnectionPool::Lease {
+public:
+  Lease(Lease &&other) noexcept;
+  auto operator=(Lease &&other) noexcept -> Lease &;
+  virtual ~Lease();
+
+  auto get() const -> Connection & { return *m_connection; }
+  auto operator*() const -> Connection & { return *m_connection; }
+  auto operator->() const -> Connection * { return m_connection; }
+
+private:
+  friend class ConnectionPool;
+
+  Lease(ConnectionPool &pool, Connection &connection);
+
+  auto release() -> void;
+
+  ConnectionPool *m_pool;
+  Connection *m_connection;
+};
+
+} // namespace Database
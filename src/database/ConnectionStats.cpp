@@ -0,0 +1,119 @@
+#include "ConnectionStats.h"
+
+#include <exception>
+
+#include "spdlog/async.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/spdlog.h"
+#include "sqlite3.h"
+
+#include "database/Connection.h"
+
+namespace {
+
+constexpr auto defaultLoggerName = "database.stats";
+
+auto defaultLogger() -> std::shared_ptr<spdlog::logger> {
+  static const auto logger = [] {
+    if (auto existing = spdlog::get(defaultLoggerName))
+      return existing;
+    return spdlog::create_async<spdlog::sinks::stderr_color_sink_mt>(
+        defaultLoggerName);
+  }();
+  return logger;
+}
+
+struct Status {
+  sqlite3_int64 current = 0;
+  sqlite3_int64 highwater = 0;
+};
+
+auto status(int op) -> Status {
+  auto value = Status{};
+  sqlite3_status64(op, &value.current, &value.highwater, 0);
+  return value;
+}
+
+} // namespace
+
+namespace Database {
+
+auto ConnectionStats::toString() const -> std::string {
+  return fmt::format(
+      "cache_used={} cache_used_shared={} cache_hits={} cache_misses={} "
+      "cache_writes={} cache_spills={} lookaside_used={} "
+      "lookaside_highwater={} lookaside_hits={} lookaside_misses_size={} "
+      "lookaside_misses_full={} schema_used={} statement_used={} "
+      "memory_used={} memory_highwater={} malloc_count={} "
+      "page_cache_used={} page_cache_overflow={}",
+      cacheUsed, cacheUsedShared, cacheHits, cacheMisses, cacheWrites,
+      cacheSpills, lookasideUsed, lookasideHighwater, lookasideHits,
+      lookasideMissesSize, lookasideMissesFull, schemaUsed, statementUsed,
+      process.memoryUsed, process.memoryHighwater, process.mallocCount,
+      process.pageCacheUsed, process.pageCacheOverflow);
+}
+
+auto memoryStats() -> MemoryStats {
+  const auto memory = status(SQLITE_STATUS_MEMORY_USED);
+  const auto pageCache = status(SQLITE_STATUS_PAGECACHE_USED);
+  return {memory.current,
+          memory.highwater,
+          status(SQLITE_STATUS_MALLOC_COUNT).current,
+          status(SQLITE_STATUS_MALLOC_SIZE).highwater,
+          pageCache.current,
+          status(SQLITE_STATUS_PAGECACHE_OVERFLOW).current,
+          status(SQLITE_STATUS_PAGECACHE_SIZE).highwater};
+}
+
+ConnectionStatsSampler::ConnectionStatsSampler(
+    Connection &connection, const ConnectionStatsSamplerOptions &options)
+    : m_connection(connection), m_options(options) {
+  if (!m_options.logger)
+    m_options.logger = defaultLogger();
+  m_sampler = std::thread{[this] { run(); }};
+}
+
+ConnectionStatsSampler::~ConnectionStatsSampler() {
+  {
+    const auto lock = std::lock_guard{m_stopMutex};
+    m_stopping = true;
+  }
+  m_stop.notify_one();
+  m_sampler.join();
+}
+
+auto ConnectionStatsSampler::samples() const -> std::uint64_t {
+  return m_samples.load();
+}
+
+auto ConnectionStatsSampler::run() -> void {
+  auto lock = std::unique_lock{m_stopMutex};
+  while (!m_stop.wait_for(lock, m_options.interval,
+                          [this] { return m_stopping; })) {
+    lock.unlock();
+    sample();
+    lock.lock();
+  }
+}
+
+auto ConnectionStatsSampler::sample() -> void {
+  const auto stats = m_connection.stats();
+  if (!m_options.callback) {
+    m_options.logger->info("connection stats {}", stats.toString());
+  } else {
+    // A failing callback must not end the sampler thread, and the process
+    // with it.
+    try {
+      m_options.callback(stats);
+    } catch (const std::exception &e) {
+      m_options.logger->error("connection stats callback failed: {}",
+                              e.what());
+    } catch (...) {
+      m_options.logger->error(
+          "connection stats callback failed: unknown exception");
+    }
+  }
+  ++m_samples;
+}
+
+} // namespace Database
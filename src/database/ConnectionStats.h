@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "database/Connection_fwd.h"
+#include "database/database_export.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Database {
+
+// Process wide allocator figures from sqlite3_status64, shared by every
+// connection. Highwater values are maxima since the process started.
+struct MemoryStats {
+  std::int64_t memoryUsed = 0;
+  std::int64_t memoryHighwater = 0;
+  // Outstanding allocations.
+  std::int64_t mallocCount = 0;
+  std::int64_t largestMalloc = 0;
+  // Pages taken from the SQLITE_CONFIG_PAGECACHE buffer, and bytes that
+  // did not fit into it and came from malloc instead.
+  std::int64_t pageCacheUsed = 0;
+  std::int64_t pageCacheOverflow = 0;
+  std::int64_t largestPageCacheAllocation = 0;
+};
+
+// sqlite3_db_status counters of one connection. Memory is in bytes; the
+// cache and lookaside hit/miss figures count since the connection opened.
+struct ConnectionStats {
+  // Page cache memory; shared caches are split evenly between their
+  // connections in cacheUsedShared.
+  std::int64_t cacheUsed = 0;
+  std::int64_t cacheUsedShared = 0;
+  std::int64_t cacheHits = 0;
+  std::int64_t cacheMisses = 0;
+  std::int64_t cacheWrites = 0;
+  // Dirty pages written out mid-transaction because the cache was full.
+  std::int64_t cacheSpills = 0;
+
+  // Lookaside slots in use, the most ever in use, and allocations served
+  // or refused because the request was too large or all slots were taken.
+  std::int64_t lookasideUsed = 0;
+  std::int64_t lookasideHighwater = 0;
+  std::int64_t lookasideHits = 0;
+  std::int64_t lookasideMissesSize = 0;
+  std::int64_t lookasideMissesFull = 0;
+
+  // Memory held by the schema and by prepared statements, including the
+  // statement cache.
+  std::int64_t schemaUsed = 0;
+  std::int64_t statementUsed = 0;
+
+  MemoryStats process;
+
+  // One "key=value" line, e.g. for logging.
+  auto toString() const -> std::string;
+};
+
+DATABASE_EXPORT auto memoryStats() -> MemoryStats;
+
+struct ConnectionStatsSamplerOptions {
+  std::chrono::milliseconds interval = std::chrono::seconds{10};
+  // Receives every sample on the sampler thread. When empty, samples are
+  // logged at info level instead. Exceptions it throws are logged as errors.
+  std::function<void(const ConnectionStats &)> callback;
+  // Defaults to the shared asynchronous "database.stats" logger writing to
+  // stderr.
+  std::shared_ptr<spdlog::logger> logger;
+};
+
+// Reads Connection::stats() every interval on a background thread until
+// destroyed. sqlite3_db_status takes the connection mutex, so the
+// connection must not be opened with ConnectionOptions::noMutex.
+class DATABASE_EXPORT ConnectionStatsSampler {
+public:
+  ConnectionStatsSampler(Connection &connection,
+                         const ConnectionStatsSamplerOptions &options = {});
+  virtual ~ConnectionStatsSampler();
+
+  ConnectionStatsSampler(const ConnectionStatsSampler &) = delete;
+  auto operator=(const ConnectionStatsSampler &)
+      -> ConnectionStatsSampler & = delete;
+
+  // Samples taken so far.
+  auto samples() const -> std::uint64_t;
+
+private:
+  auto run() -> void;
+  auto sample() -> void;
+
+  Connection &m_connection;
+  ConnectionStatsSamplerOptions m_options;
+  std::atomic<std::uint64_t> m_samples{0};
+
+  std::mutex m_stopMutex;
+  std::condition_variable m_stop;
+  bool m_stopping = false;
+  std::thread m_sampler;
+};
+
+} // namespace Database
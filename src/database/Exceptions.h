@@ -29,6 +29,19 @@ public:
   std::string parameterName;
 };
 
+class NoSuchColumn : public DatabaseRuntimeError {
+public:
+  NoSuchColumn(std::string_view columnName)
+      : DatabaseRuntimeError(""), columnName(columnName) {}
+
+  std::string columnName;
+};
+
+class LeaseTimeout : public DatabaseRuntimeError {
+public:
+  LeaseTimeout(std::string_view msg) : DatabaseRuntimeError(msg.data()) {}
+};
+
 struct QueryError : public DatabaseRuntimeError {
   QueryError(int errorCode, std::string_view msg)
       : DatabaseRuntimeError(msg.data()), errorCode(errorCode) {}
@@ -0,0 +1,75 @@
+#include "MemoryConfig.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+#include "spdlog/fmt/fmt.h"
+
+#include "database/Exceptions.h"
+
+namespace {
+
+struct MemoryState {
+  std::mutex mutex;
+  // SQLite's own allocator, captured before the first replacement.
+  std::optional<sqlite3_mem_methods> defaultAllocator;
+  std::unique_ptr<std::byte[]> pageCache;
+};
+
+auto memoryState() -> MemoryState & {
+  static auto state = MemoryState{};
+  return state;
+}
+
+auto check(int result, std::string_view what) -> void {
+  if (result != SQLITE_OK)
+    throw Database::DatabaseRuntimeError(fmt::format(
+        "Cannot configure SQLite {}: {}", what, sqlite3_errstr(result)));
+}
+
+} // namespace
+
+namespace Database {
+
+auto configureMemory(const MemoryOptions &options) -> void {
+  auto &state = memoryState();
+  const auto lock = std::lock_guard{state.mutex};
+
+  // sqlite3_config is refused while SQLite is initialized.
+  check(sqlite3_shutdown(), "shutdown");
+
+  if (!state.defaultAllocator) {
+    auto methods = sqlite3_mem_methods{};
+    check(sqlite3_config(SQLITE_CONFIG_GETMALLOC, &methods), "allocator");
+    state.defaultAllocator = methods;
+  }
+  // SQLite copies the methods.
+  auto allocator = options.allocator.value_or(*state.defaultAllocator);
+  check(sqlite3_config(SQLITE_CONFIG_MALLOC, &allocator), "allocator");
+
+  auto pageCache = std::unique_ptr<std::byte[]>{};
+  if (options.pageCache && options.pageCache->pageCount > 0) {
+    auto headerSize = 0;
+    check(sqlite3_config(SQLITE_CONFIG_PCACHE_HDRSZ, &headerSize),
+          "page cache");
+    // SQLite rounds slots down to a multiple of 8.
+    const auto slotSize = (options.pageCache->pageSize + headerSize + 7) & ~7;
+    const auto slotCount = options.pageCache->pageCount;
+    pageCache = std::make_unique<std::byte[]>(
+        static_cast<std::size_t>(slotSize) * slotCount);
+    check(sqlite3_config(SQLITE_CONFIG_PAGECACHE, pageCache.get(), slotSize,
+                         slotCount),
+          "page cache");
+  } else {
+    check(sqlite3_config(SQLITE_CONFIG_PAGECACHE, nullptr, 0, 0),
+          "page cache");
+  }
+  // The previous buffer is unused now that SQLite is shut down.
+  state.pageCache = std::move(pageCache);
+
+  check(sqlite3_initialize(), "initialization");
+}
+
+} // namespace Database
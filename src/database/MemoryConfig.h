@@ -0,0 +1,35 @@
+#pragma once
+
+#include <optional>
+
+#include "sqlite3.h"
+
+#include "database/database_export.h"
+
+namespace Database {
+
+// Page cache preallocated by the library (SQLITE_CONFIG_PAGECACHE): room
+// for pageCount pages of pageSize bytes plus SQLite's per-page header.
+// Pages beyond that, or of databases with a larger page size, come from
+// the allocator.
+struct PageCacheOptions {
+  int pageSize = 4096;
+  int pageCount = 0;
+};
+
+// Process wide SQLite memory setup. Unset members restore SQLite's
+// defaults.
+struct MemoryOptions {
+  std::optional<PageCacheOptions> pageCache;
+  // Allocator used for everything SQLite allocates, e.g.
+  // sizeClassAllocator() or a wrapper around jemalloc or mimalloc.
+  std::optional<sqlite3_mem_methods> allocator;
+};
+
+// Shuts SQLite down, applies options and initializes it again. Every
+// Connection must be closed first: memory they hold would be released to
+// the wrong allocator. Throws DatabaseRuntimeError when SQLite rejects an
+// option.
+DATABASE_EXPORT auto configureMemory(const MemoryOptions &options) -> void;
+
+} // namespace Database
@@ -0,0 +1,308 @@
+#include "Metrics.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "spdlog/fmt/fmt.h"
+
+namespace {
+
+auto highestBit(std::uint64_t value) -> int {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(value);
+#else
+  auto bit = 0;
+  while (value >>= 1)
+    ++bit;
+  return bit;
+#endif
+}
+
+auto toMicroseconds(std::chrono::nanoseconds duration) -> double {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+auto jsonEscape(std::string_view text) -> std::string {
+  auto escaped = std::string{};
+  escaped.reserve(text.size());
+  for (const auto c : text) {
+    switch (c) {
+    case '"':
+      escaped += "\\\"";
+      break;
+    case '\\':
+      escaped += "\\\\";
+      break;
+    case '\n':
+      escaped += "\\n";
+      break;
+    case '\t':
+      escaped += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+        escaped += fmt::format("\\u{:04x}", c);
+      else
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+
+// Shared by text and JSON output, in this order.
+constexpr auto quantiles = std::array{0.5, 0.9, 0.99, 0.999};
+constexpr auto quantileNames = std::array{"p50", "p90", "p99", "p999"};
+
+auto histogramText(std::string_view name,
+                   const Database::LatencyHistogram &histogram)
+    -> std::string {
+  auto text = fmt::format("  {:<9} n={}", name, histogram.count());
+  for (std::size_t i = 0; i < quantiles.size(); ++i)
+    text += fmt::format(" {}={:.1f}us", quantileNames[i],
+                        toMicroseconds(histogram.percentile(quantiles[i])));
+  text += fmt::format(" max={:.1f}us mean={:.1f}us\n",
+                      toMicroseconds(histogram.max()),
+                      toMicroseconds(histogram.mean()));
+  return text;
+}
+
+auto histogramJson(const Database::LatencyHistogram &histogram)
+    -> std::string {
+  auto json = fmt::format(R"({{"count":{})", histogram.count());
+  for (std::size_t i = 0; i < quantiles.size(); ++i)
+    json += fmt::format(R"(,"{}_ns":{})", quantileNames[i],
+                        histogram.percentile(quantiles[i]).count());
+  json += fmt::format(R"(,"max_ns":{},"mean_ns":{}}})",
+                      histogram.max().count(), histogram.mean().count());
+  return json;
+}
+
+// Recorders of the running threads, and the merged samples of the threads
+// that exited.
+struct ThreadRegistry {
+  std::mutex mutex;
+  std::vector<Database::detail::ThreadLatencies *> threads;
+  std::unordered_map<std::string, Database::QueryLatencies> retired;
+};
+
+auto threadRegistry() -> ThreadRegistry & {
+  static auto registry = ThreadRegistry{};
+  return registry;
+}
+
+std::atomic<std::uint64_t> nextThreadId{1};
+
+} // namespace
+
+namespace Database {
+
+auto LatencyHistogram::bucketOf(std::uint64_t nanoseconds) -> std::size_t {
+  if (nanoseconds < subBuckets)
+    return static_cast<std::size_t>(nanoseconds);
+
+  const auto exponent = std::min(highestBit(nanoseconds), maxExponent);
+  if (exponent == maxExponent && (nanoseconds >> (maxExponent + 1)) != 0)
+    return bucketCount - 1;
+
+  const auto subBucket = (nanoseconds >> (exponent - subBucketBits)) &
+                         (subBuckets - 1);
+  return (exponent - subBucketBits + 1) * subBuckets + subBucket;
+}
+
+auto LatencyHistogram::bucketUpperBound(std::size_t bucket) -> std::uint64_t {
+  if (bucket < subBuckets)
+    return bucket;
+
+  const auto exponent =
+      static_cast<int>(bucket / subBuckets) + subBucketBits - 1;
+  const auto subBucket = bucket % subBuckets;
+  const auto width = std::uint64_t{1} << (exponent - subBucketBits);
+  return ((subBuckets + subBucket) << (exponent - subBucketBits)) + width - 1;
+}
+
+auto LatencyHistogram::record(std::chrono::nanoseconds duration) -> void {
+  const auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(
+      duration.count(), 0));
+  ++m_buckets[bucketOf(value)];
+  ++m_count;
+  m_sum += value;
+  m_max = std::max(m_max, value);
+}
+
+auto LatencyHistogram::merge(const LatencyHistogram &other) -> void {
+  for (std::size_t i = 0; i < bucketCount; ++i)
+    m_buckets[i] += other.m_buckets[i];
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+  m_max = std::max(m_max, other.m_max);
+}
+
+auto LatencyHistogram::max() const -> std::chrono::nanoseconds {
+  return std::chrono::nanoseconds{m_max};
+}
+
+auto LatencyHistogram::mean() const -> std::chrono::nanoseconds {
+  return std::chrono::nanoseconds{m_count ? m_sum / m_count : 0};
+}
+
+auto LatencyHistogram::percentile(double quantile) const
+    -> std::chrono::nanoseconds {
+  if (m_count == 0)
+    return {};
+
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(quantile * m_count + 0.5));
+  auto seen = std::uint64_t{0};
+  for (std::size_t i = 0; i < bucketCount; ++i) {
+    seen += m_buckets[i];
+    if (seen >= rank)
+      return std::chrono::nanoseconds{std::min(bucketUpperBound(i), m_max)};
+  }
+  return max();
+}
+
+auto MetricsSnapshot::toText() const -> std::string {
+  auto text = std::string{};
+  for (const auto &query : queries) {
+    text += fmt::format("{}\n", query.sql);
+    text += histogramText("prepare", query.prepare);
+    text += histogramText("first_row", query.firstRow);
+    text += histogramText("execute", query.execute);
+  }
+  return text;
+}
+
+auto MetricsSnapshot::toJson() const -> std::string {
+  auto json = std::string{R"({"queries":[)"};
+  for (std::size_t i = 0; i < queries.size(); ++i) {
+    const auto &query = queries[i];
+    json += fmt::format(
+        R"({}{{"sql":"{}","prepare":{},"first_row":{},"execute":{}}})",
+        i ? "," : "", jsonEscape(query.sql), histogramJson(query.prepare),
+        histogramJson(query.firstRow), histogramJson(query.execute));
+  }
+  json += "]}";
+  return json;
+}
+
+namespace detail {
+
+std::atomic<bool> metricsEnabled{false};
+
+auto AtomicLatencyHistogram::record(std::chrono::nanoseconds duration)
+    -> void {
+  const auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(
+      duration.count(), 0));
+  bump(m_buckets[LatencyHistogram::bucketOf(value)], 1);
+  bump(m_count, 1);
+  bump(m_sum, value);
+  if (value > m_max.load(std::memory_order_relaxed))
+    m_max.store(value, std::memory_order_relaxed);
+}
+
+auto AtomicLatencyHistogram::mergeInto(LatencyHistogram &histogram) const
+    -> void {
+  for (std::size_t i = 0; i < LatencyHistogram::bucketCount; ++i)
+    histogram.m_buckets[i] += m_buckets[i].load(std::memory_order_relaxed);
+  histogram.m_count += m_count.load(std::memory_order_relaxed);
+  histogram.m_sum += m_sum.load(std::memory_order_relaxed);
+  histogram.m_max =
+      std::max(histogram.m_max, m_max.load(std::memory_order_relaxed));
+}
+
+auto AtomicLatencyHistogram::reset() -> void {
+  for (auto &bucket : m_buckets)
+    bucket.store(0, std::memory_order_relaxed);
+  m_count.store(0, std::memory_order_relaxed);
+  m_sum.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+ThreadLatencies::ThreadLatencies() : m_id(nextThreadId++) {
+  auto &registry = threadRegistry();
+  const auto lock = std::lock_guard{registry.mutex};
+  registry.threads.push_back(this);
+}
+
+ThreadLatencies::~ThreadLatencies() {
+  auto &registry = threadRegistry();
+  const auto lock = std::lock_guard{registry.mutex};
+  mergeInto(registry.retired);
+  registry.threads.erase(
+      std::find(begin(registry.threads), end(registry.threads), this));
+}
+
+auto ThreadLatencies::current() -> ThreadLatencies & {
+  thread_local ThreadLatencies latencies;
+  return latencies;
+}
+
+auto ThreadLatencies::forSql(std::string_view sql) -> QueryLatencyRecorder & {
+  // Lookups need no lock: only this thread inserts.
+  const auto it = m_recorders.find(sql);
+  if (it != m_recorders.end())
+    return *it->second;
+
+  auto recorder = std::make_unique<QueryLatencyRecorder>(sql);
+  const auto lock = std::lock_guard{m_mutex};
+  return *m_recorders.emplace(recorder->sql, std::move(recorder))
+              .first->second;
+}
+
+auto ThreadLatencies::mergeInto(
+    std::unordered_map<std::string, QueryLatencies> &merged) const -> void {
+  const auto lock = std::lock_guard{m_mutex};
+  for (const auto &[sql, recorder] : m_recorders) {
+    auto &latencies = merged[std::string{sql}];
+    recorder->prepare.mergeInto(latencies.prepare);
+    recorder->firstRow.mergeInto(latencies.firstRow);
+    recorder->execute.mergeInto(latencies.execute);
+  }
+}
+
+auto ThreadLatencies::reset() -> void {
+  const auto lock = std::lock_guard{m_mutex};
+  for (auto &[sql, recorder] : m_recorders) {
+    recorder->prepare.reset();
+    recorder->firstRow.reset();
+    recorder->execute.reset();
+  }
+}
+
+} // namespace detail
+
+auto Metrics::setEnabled(bool enabled) -> void {
+  detail::metricsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+auto Metrics::snapshot() -> MetricsSnapshot {
+  auto merged = std::unordered_map<std::string, QueryLatencies>{};
+  {
+    auto &registry = threadRegistry();
+    const auto lock = std::lock_guard{registry.mutex};
+    merged = registry.retired;
+    for (const auto &thread : registry.threads)
+      thread->mergeInto(merged);
+  }
+
+  auto snapshot = MetricsSnapshot{};
+  snapshot.queries.reserve(merged.size());
+  for (auto &[sql, latencies] : merged) {
+    latencies.sql = sql;
+    snapshot.queries.push_back(std::move(latencies));
+  }
+  std::sort(begin(snapshot.queries), end(snapshot.queries),
+            [](const auto &lhs, const auto &rhs) { return lhs.sql < rhs.sql; });
+  return snapshot;
+}
+
+auto Metrics::reset() -> void {
+  auto &registry = threadRegistry();
+  const auto lock = std::lock_guard{registry.mutex};
+  for (auto &[sql, latencies] : registry.retired)
+    latencies = QueryLatencies{};
+  for (const auto &thread : registry.threads)
+    thread->reset();
+}
+
+} // namespace Database
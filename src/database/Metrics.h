@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "database/database_export.h"
+
+namespace Database {
+
+namespace detail {
+class AtomicLatencyHistogram;
+}
+
+// Log-linear (HDR style) histogram of nanosecond latencies: 16 linear
+// sub-buckets per power of two, so a reported value is within 1/16 of the
+// recorded one. Values above ~18 minutes land in the last bucket.
+class DATABASE_EXPORT LatencyHistogram {
+public:
+  static constexpr auto subBucketBits = 4;
+  static constexpr auto subBuckets = std::size_t{1} << subBucketBits;
+  static constexpr auto maxExponent = 40;
+  static constexpr auto bucketCount =
+      (maxExponent - subBucketBits + 2) * subBuckets;
+
+  static auto bucketOf(std::uint64_t nanoseconds) -> std::size_t;
+  // Largest value that falls into the bucket.
+  static auto bucketUpperBound(std::size_t bucket) -> std::uint64_t;
+
+  auto record(std::chrono::nanoseconds duration) -> void;
+  auto merge(const LatencyHistogram &other) -> void;
+
+  auto count() const -> std::uint64_t { return m_count; }
+  auto max() const -> std::chrono::nanoseconds;
+  auto mean() const -> std::chrono::nanoseconds;
+  // quantile in [0, 1]; 0ns when empty.
+  auto percentile(double quantile) const -> std::chrono::nanoseconds;
+
+  auto bucketCounts() const
+      -> const std::array<std::uint64_t, bucketCount> & {
+    return m_buckets;
+  }
+
+private:
+  friend class detail::AtomicLatencyHistogram;
+
+  std::array<std::uint64_t, bucketCount> m_buckets{};
+  std::uint64_t m_count = 0;
+  std::uint64_t m_sum = 0;
+  std::uint64_t m_max = 0;
+};
+
+// Merged latencies of every Query with the same normalized SQL.
+struct QueryLatencies {
+  std::string sql;
+  // Statement compilation; cache hits are not prepares.
+  LatencyHistogram prepare;
+  // First sqlite3_step of a run, i.e. time to the first row (or to the
+  // end of a statement returning none).
+  LatencyHistogram firstRow;
+  // All steps of a run until SQLITE_DONE, an error or a reset.
+  LatencyHistogram execute;
+};
+
+struct DATABASE_EXPORT MetricsSnapshot {
+  // Ordered by SQL.
+  std::vector<QueryLatencies> queries;
+
+  auto toText() const -> std::string;
+  auto toJson() const -> std::string;
+};
+
+namespace detail {
+
+// Written only by the thread owning it; relaxed atomics let snapshot()
+// read it concurrently without locks on the recording path. reset() from
+// another thread races with record(), see Metrics::reset().
+class DATABASE_EXPORT AtomicLatencyHistogram {
+public:
+  auto record(std::chrono::nanoseconds duration) -> void;
+  auto mergeInto(LatencyHistogram &histogram) const -> void;
+  auto reset() -> void;
+
+private:
+  static auto bump(std::atomic<std::uint64_t> &value, std::uint64_t by)
+      -> void {
+    value.store(value.load(std::memory_order_relaxed) + by,
+                std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<std::uint64_t>, LatencyHistogram::bucketCount>
+      m_buckets{};
+  std::atomic<std::uint64_t> m_count{0};
+  std::atomic<std::uint64_t> m_sum{0};
+  std::atomic<std::uint64_t> m_max{0};
+};
+
+struct QueryLatencyRecorder {
+  explicit QueryLatencyRecorder(std::string_view sql) : sql(sql) {}
+
+  const std::string sql;
+  AtomicLatencyHistogram prepare;
+  AtomicLatencyHistogram firstRow;
+  AtomicLatencyHistogram execute;
+};
+
+// Recorders of one thread, keyed by normalized SQL. When the thread exits
+// its samples are merged into a process wide total, which keeps one set of
+// histograms per SQL however many threads come and go, and the recorders
+// are freed.
+class DATABASE_EXPORT ThreadLatencies {
+public:
+  static auto current() -> ThreadLatencies &;
+
+  ~ThreadLatencies();
+
+  // Unique per thread; unlike the address it is never reused.
+  auto id() const -> std::uint64_t { return m_id; }
+
+  // Only called by the owning thread. The reference stays valid until the
+  // thread exits.
+  auto forSql(std::string_view sql) -> QueryLatencyRecorder &;
+
+  auto mergeInto(std::unordered_map<std::string, QueryLatencies> &merged)
+      const -> void;
+  auto reset() -> void;
+
+private:
+  ThreadLatencies();
+
+  const std::uint64_t m_id;
+  mutable std::mutex m_mutex;
+  // Keyed by the SQL the recorder owns, so lookups do not allocate.
+  std::unordered_map<std::string_view, std::unique_ptr<QueryLatencyRecorder>>
+      m_recorders;
+};
+
+extern DATABASE_EXPORT std::atomic<bool> metricsEnabled;
+
+} // namespace detail
+
+// Process wide latency metrics of every Query, recorded per thread while
+// enabled and merged on demand.
+class DATABASE_EXPORT Metrics {
+public:
+  static auto setEnabled(bool enabled) -> void;
+  static auto enabled() -> bool {
+    return detail::metricsEnabled.load(std::memory_order_relaxed);
+  }
+
+  static auto snapshot() -> MetricsSnapshot;
+  // Zeroes every histogram; the SQL keys stay registered. Recording bumps
+  // each counter with a relaxed load and store, so a sample recorded while
+  // reset() runs can store back a value read before the reset. Until the
+  // next reset, count() may then disagree with the bucket totals.
+  static auto reset() -> void;
+};
+
+} // namespace Database
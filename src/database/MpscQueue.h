@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace Database::detail {
+
+// Unbounded multi-producer single-consumer queue (Vyukov). push() is
+// wait-free for producers; pop() and empty() must only be called by the
+// single consumer.
+template <typename ValueT> class MpscQueue {
+public:
+  MpscQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+  ~MpscQueue() {
+    while (pop()) {
+    }
+    if (m_tail != &m_stub)
+      delete m_tail;
+  }
+
+  MpscQueue(const MpscQueue &) = delete;
+  auto operator=(const MpscQueue &) -> MpscQueue & = delete;
+
+  auto push(ValueT value) -> void {
+    const auto node = new Node{std::move(value)};
+    const auto previous = m_head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  auto pop() -> std::optional<ValueT> {
+    auto tail = m_tail;
+    auto next = tail->next.load(std::memory_order_acquire);
+    if (!next)
+      return std::nullopt;
+
+    // The stub only links to the first real node; nodes are freed once the
+    // consumer moved past them.
+    auto value = std::move(*next->value);
+    next->value.reset();
+    m_tail = next;
+    if (tail != &m_stub)
+      delete tail;
+    return value;
+  }
+
+  // May report a push in progress as empty; the producer's wake-up covers
+  // that case.
+  auto empty() const -> bool {
+    return m_tail->next.load(std::memory_order_acquire) == nullptr;
+  }
+
+private:
+  struct Node {
+    Node() = default;
+    explicit Node(ValueT &&value) : value(std::move(value)) {}
+
+    std::atomic<Node *> next{nullptr};
+    std::optional<ValueT> value;
+  };
+
+  std::atomic<Node *> m_head;
+  Node *m_tail;
+  Node m_stub;
+};
+
+} // namespace Database::detail
@@ -1,41 +1,32 @@
 #include "Query.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cinttypes>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
-#include <locale>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
-#include "spdlog/spdlog.h"
+#include "spdlog/fmt/fmt.h"
 #include "sqlite/sqlite3.h"
 
 #include "database/Connection.h"
 #include "database/Exceptions.h"
-
-namespace {
-
-auto getLowerCaseString(std::string_view text) -> std::string {
-  std::string lowercaseName = text.data();
-  transform(begin(text), end(text), begin(lowercaseName),
-            [=](const auto c) { return tolower(c, std::locale()); });
-  return lowercaseName;
-}
-
-struct statement_deleter {
-  auto operator()(sqlite3_stmt *statement) -> void {
-    const auto rc = sqlite3_finalize(statement);
-  }
-};
-
-} // namespace
+#include "database/Metrics.h"
+#include "database/StatementCache.h"
+#include "database/StatementStats.h"
+#include "database/Trace.h"
 
 namespace Database {
 
@@ -43,71 +34,279 @@ Query::~Query() {}
 
 class Query::Impl {
 public:
-  Impl(std::string_view sql, sqlite3 *dbConnection);
+  Impl(std::string_view sql, Connection &connection,
+       const QueryOptions &options);
+  ~Impl();
 
   auto execute() -> void;
-  auto getIndex(std::string_view fieldName) const -> int64_t;
+  auto reset() -> void;
+  auto clearBindings() -> void;
+  auto next() -> bool;
+  auto start() -> bool;
+  auto getIndex(std::string_view fieldName) const -> int;
   auto getStatement() const -> sqlite3_stmt *;
+  auto getStatementForBinding() -> sqlite3_stmt *;
+  auto getStatementHandle() -> detail::StatementHandle &;
+
+  template <typename BufferT> auto bindOwned(int idx, BufferT &&value) -> void;
 
 private:
-  std::unique_ptr<sqlite3_stmt, statement_deleter> m_dbStatement;
-  std::vector<std::string> m_columns;
+  enum class State { Prepared, Row, Done };
+  using OwnedValue =
+      std::variant<std::monostate, std::string, std::vector<std::byte>>;
+
+  auto step() -> bool;
+  auto startRun() -> void;
+  auto finishRun() -> void;
+  auto latencies() -> detail::QueryLatencyRecorder &;
+
+  // Buffers moved in by set(), bound without a copy. Declared before the
+  // statement so they outlive its reset when the Query goes away.
+  std::vector<OwnedValue> m_ownedValues;
+  detail::StatementHandle m_dbStatement;
+  State m_state = State::Prepared;
+  // Set while a run is measured for the statement stats registry or the
+  // latency metrics.
+  std::optional<StatementRun> m_run;
+  // Whether m_run holds a status baseline for the registry, and whether it
+  // is recorded into the latency histograms.
+  bool m_runHasStatus = false;
+  bool m_runHasLatencies = false;
+  // Histograms of this statement on the thread, by ThreadLatencies id, that
+  // last recorded into them.
+  std::uint64_t m_latenciesThread = 0;
+  detail::QueryLatencyRecorder *m_latencies = nullptr;
 };
 
-Query::Impl::Impl(std::string_view sql, sqlite3 *dbConnection) {
-  const char *outSql;
-  sqlite3_stmt *statement;
-  const auto result = sqlite3_prepare_v2(dbConnection, sql.data(), sql.size(),
-                                         &statement, &outSql);
-  m_dbStatement =
-      std::unique_ptr<sqlite3_stmt, statement_deleter>(std::move(statement));
-  if (result != SQLITE_OK) {
-    throw QueryError(result, sqlite3_errmsg(dbConnection));
+Query::Impl::Impl(std::string_view sql, Connection &connection,
+                  const QueryOptions &options) {
+  auto &cache = connection.getStatementCache();
+  if (options.useStatementCache)
+    m_dbStatement = cache.acquire(sql);
+
+  if (!m_dbStatement) {
+    const auto dbConnection = connection.getRawConnection();
+    const char *outSql;
+    sqlite3_stmt *statement = nullptr;
+    const auto start = std::chrono::steady_clock::now();
+    const auto result =
+        detail::traced(TraceEvent::Prepare, statement, 0, [&] {
+          return sqlite3_prepare_v2(dbConnection, sql.data(), sql.size(),
+                                    &statement, &outSql);
+        });
+    auto prepared = detail::StatementPtr{statement};
+    if (result != SQLITE_OK) {
+      throw QueryError(result, sqlite3_errmsg(dbConnection));
+    }
+
+    const auto prepareTime = std::chrono::steady_clock::now() - start;
+    m_dbStatement = options.useStatementCache
+                        ? cache.store(sql, std::move(prepared))
+                        : detail::StatementHandle{
+                              std::move(prepared),
+                              options.memoryResource
+                                  ? options.memoryResource
+                                  : std::pmr::get_default_resource()};
+
+    if (const auto registry = detail::statementStatsRegistry.load(
+            std::memory_order_acquire))
+      registry->recordPrepare(m_dbStatement.normalizedSql(), prepareTime);
+    if (Metrics::enabled())
+      latencies().prepare.record(prepareTime);
   }
 }
 
-auto Query::Impl::execute() -> void {
+Query::Impl::~Impl() { finishRun(); }
+
+auto Query::Impl::step() -> bool {
   const auto stmt = m_dbStatement.get();
 
-  auto val = sqlite3_step(stmt);
-  if (val != SQLITE_DONE) {
-    while (sqlite3_step(stmt) != SQLITE_ROW) {
-    }
+  const auto firstStep = m_state == State::Prepared;
+  if (firstStep)
+    startRun();
+
+  const auto start =
+      m_run ? std::chrono::steady_clock::now()
+            : std::chrono::steady_clock::time_point{};
+  const auto result = detail::traced(TraceEvent::Step, stmt, 0,
+                                     [stmt] { return sqlite3_step(stmt); });
+  if (m_run) {
+    const auto stepTime = std::chrono::steady_clock::now() - start;
+    m_run->stepTime += stepTime;
+    if (firstStep && m_runHasLatencies)
+      latencies().firstRow.record(stepTime);
+  }
+
+  if (result == SQLITE_ROW) {
+    m_state = State::Row;
+    if (m_run)
+      ++m_run->rows;
+    return true;
   }
-  if (val == SQLITE_ERROR) {
-    auto db = sqlite3_db_handle(m_dbStatement.get());
-    const auto errorStr = sqlite3_errmsg(db);
-    const auto errorCode = sqlite3_errcode(db);
 
-    throw QueryError(errorCode, errorStr);
+  m_state = State::Done;
+  finishRun();
+  if (result == SQLITE_DONE)
+    return false;
+
+  auto db = sqlite3_db_handle(stmt);
+  const auto errorStr = sqlite3_errmsg(db);
+  const auto errorCode = sqlite3_errcode(db);
+
+  throw QueryError(errorCode, errorStr);
+}
+
+auto Query::Impl::execute() -> void {
+  if (m_state != State::Prepared)
+    reset();
+
+  step();
+}
+
+auto Query::Impl::startRun() -> void {
+  const auto registry =
+      detail::statementStatsRegistry.load(std::memory_order_acquire);
+  const auto recordLatencies = Metrics::enabled();
+  if (!registry && !recordLatencies)
+    return;
+
+  m_run.emplace();
+  m_runHasStatus = registry != nullptr;
+  m_runHasLatencies = recordLatencies;
+  // Counters are cumulative per statement; the run records the delta.
+  if (m_runHasStatus)
+    m_run->status = detail::statementStatus(m_dbStatement.get());
+}
+
+auto Query::Impl::finishRun() -> void {
+  if (!m_run)
+    return;
+  auto run = *std::exchange(m_run, std::nullopt);
+
+  // Recorded on the thread finishing the run, which need not be the one
+  // that started it.
+  if (m_runHasLatencies)
+    latencies().execute.record(run.stepTime);
+
+  const auto registry =
+      detail::statementStatsRegistry.load(std::memory_order_acquire);
+  if (!registry || !m_runHasStatus)
+    return;
+
+  const auto stmt = m_dbStatement.get();
+  const auto before = run.status;
+  const auto after = detail::statementStatus(stmt);
+  run.status = {after.fullscanSteps - before.fullscanSteps,
+                after.sorts - before.sorts,
+                after.autoindexes - before.autoindexes,
+                after.vmSteps - before.vmSteps,
+                // SQLite only counts a run once the statement is reset.
+                1,
+                after.memoryUsed};
+  registry->recordRun(m_dbStatement.normalizedSql(), run);
+}
+
+auto Query::Impl::latencies() -> detail::QueryLatencyRecorder & {
+  // The lookup hashes the SQL, so it is done once per thread for the Query
+  // and, through the statement cache, for the statement.
+  auto &thread = detail::ThreadLatencies::current();
+  if (thread.id() != m_latenciesThread) {
+    m_latencies = m_dbStatement.latencies(thread.id());
+    if (!m_latencies) {
+      m_latencies = &thread.forSql(m_dbStatement.normalizedSql());
+      m_dbStatement.setLatencies(thread.id(), *m_latencies);
+    }
+    m_latenciesThread = thread.id();
   }
+  return *m_latencies;
+}
 
-  spdlog::debug("Called \"{}\"\n", sqlite3_normalized_sql(stmt));
+auto Query::Impl::reset() -> void {
+  // The result code repeats the error of the last step, which was already
+  // reported by step().
+  finishRun();
+  [[maybe_unused]] const auto rc = sqlite3_reset(m_dbStatement.get());
+  m_state = State::Prepared;
+}
 
-  const auto columnCount = sqlite3_column_count(stmt);
-  for (auto i = 0; i < columnCount; ++i) {
-    const auto name = getLowerCaseString({sqlite3_column_name(stmt, i)});
+auto Query::Impl::clearBindings() -> void {
+  sqlite3_clear_bindings(m_dbStatement.get());
+}
 
-    spdlog::debug("Got column: '{}'\n", name);
-    m_columns.emplace_back(name);
+auto Query::Impl::next() -> bool {
+  switch (m_state) {
+  case State::Prepared:
+    execute();
+    return m_state == State::Row;
+  case State::Row:
+    return step();
+  case State::Done:
+    return false;
   }
+  return false;
+}
+
+auto Query::Impl::start() -> bool {
+  if (m_state == State::Prepared)
+    execute();
+  return m_state == State::Row;
 }
 
-auto Query::Impl::getIndex(std::string_view fieldName) const -> int64_t {
-  const auto beginIt = begin(m_columns);
-  const auto it = find(beginIt, end(m_columns), fieldName);
-  return distance(beginIt, it);
+auto Query::Impl::getIndex(std::string_view fieldName) const -> int {
+  const auto idx = m_dbStatement.columns().find(fieldName);
+  if (idx == detail::ColumnIndex::npos)
+    throw NoSuchColumn(fieldName);
+
+  return idx;
 }
 
 auto Query::Impl::getStatement() const -> sqlite3_stmt * {
   return m_dbStatement.get();
 }
 
-Query::Query(std::string_view sql, Connection &connection)
-    : m_impl(std::make_unique<Impl>(sql, connection.getRawConnection())) {}
+auto Query::Impl::getStatementHandle() -> detail::StatementHandle & {
+  return m_dbStatement;
+}
+
+auto Query::Impl::getStatementForBinding() -> sqlite3_stmt * {
+  // SQLite refuses new bindings while a statement is running.
+  if (m_state != State::Prepared)
+    reset();
+  return m_dbStatement.get();
+}
+
+template <typename BufferT>
+auto Query::Impl::bindOwned(int idx, BufferT &&value) -> void {
+  const auto stmt = m_dbStatement.get();
+  if (m_ownedValues.empty())
+    m_ownedValues.resize(sqlite3_bind_parameter_count(stmt) + 1);
+  if (idx <= 0 || static_cast<std::size_t>(idx) >= m_ownedValues.size())
+    throw QueryError(SQLITE_RANGE, sqlite3_errstr(SQLITE_RANGE));
+
+  // The previous buffer stays alive until the statement no longer points
+  // to it.
+  const auto previous =
+      std::exchange(m_ownedValues[idx], OwnedValue{std::move(value)});
+  const auto &buffer = std::get<std::decay_t<BufferT>>(m_ownedValues[idx]);
+  detail::bindParameterValue(stmt, idx, buffer, BindLifetime::Static);
+}
+
+Query::Query(std::string_view sql, Connection &connection,
+             const QueryOptions &options)
+    : m_impl(std::make_unique<Impl>(sql, connection, options)) {}
 
 auto Query::execute() -> void { m_impl->execute(); }
 
+auto Query::reset() -> void { m_impl->reset(); }
+
+auto Query::clearBindings() -> void { m_impl->clearBindings(); }
+
+auto Query::next() -> bool { return m_impl->next(); }
+
+auto Query::rows() -> RowRange { return RowRange{*this}; }
+
+auto Query::start() -> bool { return m_impl->start(); }
+
 namespace detail {
 
 template <> auto getFromQuery<double>(sqlite3_stmt *stmt, int idx) -> double {
@@ -122,95 +321,283 @@ template <> auto getFromQuery<int>(sqlite3_stmt *stmt, int idx) -> int {
   return sqlite3_column_int(stmt, idx);
 }
 
-template <> auto getFromQuery(sqlite3_stmt *stmt, int idx) -> std::string {
+template <>
+auto getFromQuery(sqlite3_stmt *stmt, int idx) -> std::string_view {
+  // Text first, then its size, as the conversion may change the size.
   const auto text = sqlite3_column_text(stmt, idx);
   const size_t length = sqlite3_column_bytes(stmt, idx);
   return {reinterpret_cast<const char *>(text), length};
 }
 
+template <> auto getFromQuery(sqlite3_stmt *stmt, int idx) -> std::string {
+  return std::string{getFromQuery<std::string_view>(stmt, idx)};
+}
+
+template <> auto getFromQuery(sqlite3_stmt *stmt, int idx) -> ByteSpan {
+  const auto value =
+      static_cast<const std::byte *>(sqlite3_column_blob(stmt, idx));
+  const size_t length = sqlite3_column_bytes(stmt, idx);
+  return {value, length};
+}
+
 template <>
 auto getFromQuery(sqlite3_stmt *stmt, int idx) -> std::vector<std::byte> {
-  const auto value = static_cast<const char *>(sqlite3_column_blob(stmt, idx));
-  const auto length = sqlite3_column_bytes(stmt, idx);
-  auto vec = std::vector<std::byte>{static_cast<unsigned long>(length)};
+  const auto value = getFromQuery<ByteSpan>(stmt, idx);
+  return {value.begin(), value.end()};
+}
+
+template <>
+auto getFromQuery(sqlite3_stmt *stmt, int idx,
+                  std::pmr::memory_resource *resource) -> std::pmr::string {
+  const auto value = getFromQuery<std::string_view>(stmt, idx);
+  return {value.data(), value.size(), resource};
+}
+
+template <>
+auto getFromQuery(sqlite3_stmt *stmt, int idx,
+                  std::pmr::memory_resource *resource)
+    -> std::pmr::vector<std::byte> {
+  const auto value = getFromQuery<ByteSpan>(stmt, idx);
+  return {value.begin(), value.end(), resource};
+}
+
+template <>
+auto getFromQuery(sqlite3_stmt *stmt, int idx) -> std::pmr::string {
+  return getFromQuery<std::pmr::string>(stmt, idx,
+                                        std::pmr::get_default_resource());
+}
 
-  for (size_t i = 0; i < length; ++i) {
-    vec[i] = static_cast<std::byte>(*(value + i));
+template <>
+auto getFromQuery(sqlite3_stmt *stmt, int idx) -> std::pmr::vector<std::byte> {
+  return getFromQuery<std::pmr::vector<std::byte>>(
+      stmt, idx, std::pmr::get_default_resource());
+}
+
+template <> auto getFromQuery(sqlite3_stmt *stmt, int idx) -> Value {
+  switch (sqlite3_column_type(stmt, idx)) {
+  case SQLITE_INTEGER:
+    return getFromQuery<std::int64_t>(stmt, idx);
+  case SQLITE_FLOAT:
+    return getFromQuery<double>(stmt, idx);
+  case SQLITE_TEXT:
+    return getFromQuery<std::string>(stmt, idx);
+  case SQLITE_BLOB:
+    return getFromQuery<std::vector<std::byte>>(stmt, idx);
+  default:
+    return nullptr;
   }
+}
 
-  return vec;
+template <>
+auto getIntoBuffer(sqlite3_stmt *stmt, int idx, std::string &buffer) -> bool {
+  const auto value = getFromQuery<std::string_view>(stmt, idx);
+  buffer.assign(value.data(), value.size());
+  return sqlite3_column_type(stmt, idx) != SQLITE_NULL;
 }
 
 template <>
-auto bindParameterValue(sqlite3_stmt *stmt, int idx, const int &value) -> void {
-  fmt::print("idx: {} value", idx);
-  const auto val = sqlite3_bind_int64(stmt, idx, value); // TODO Błędne kody
-  if (val != SQLITE_OK)
-    throw DatabaseRuntimeError(fmt::format("dupa {}", val));
+auto getIntoBuffer(sqlite3_stmt *stmt, int idx, std::vector<std::byte> &buffer)
+    -> bool {
+  const auto value = getFromQuery<ByteSpan>(stmt, idx);
+  buffer.assign(value.begin(), value.end());
+  return sqlite3_column_type(stmt, idx) != SQLITE_NULL;
 }
 
 template <>
-auto bindParameterValue(sqlite3_stmt *stmt, int idx, const double &value)
-    -> void {
-  fmt::print("idx: {} value", idx);
-  const auto val = sqlite3_bind_double(stmt, idx, value); // TODO Błędne kody
-  if (val != SQLITE_OK)
-    throw DatabaseRuntimeError(fmt::format("dupa {}", val));
+auto getIntoBuffer(sqlite3_stmt *stmt, int idx, std::pmr::string &buffer)
+    -> bool {
+  const auto value = getFromQuery<std::string_view>(stmt, idx);
+  buffer.assign(value.data(), value.size());
+  return sqlite3_column_type(stmt, idx) != SQLITE_NULL;
 }
 
 template <>
-auto bindParameterValue(sqlite3_stmt *stmt, int idx, const std::string &value)
-    -> void {
-  fmt::print("idx: {} value", idx);
-  const auto val = sqlite3_bind_text(stmt, idx, value.data(), value.size(),
-                                     SQLITE_TRANSIENT); // TODO Błędne kody
-  if (val != SQLITE_OK)
-    throw DatabaseRuntimeError(fmt::format("dupa {}", val));
+auto getIntoBuffer(sqlite3_stmt *stmt, int idx,
+                   std::pmr::vector<std::byte> &buffer) -> bool {
+  const auto value = getFromQuery<ByteSpan>(stmt, idx);
+  buffer.assign(value.begin(), value.end());
+  return sqlite3_column_type(stmt, idx) != SQLITE_NULL;
+}
+
+namespace {
+
+template <typename BindT>
+auto bindChecked(sqlite3_stmt *stmt, int idx, BindT &&bind) -> void {
+  const auto result = traced(TraceEvent::Bind, stmt, idx, bind);
+  if (result != SQLITE_OK)
+    throw QueryError(result, sqlite3_errstr(result));
+}
+
+auto destructorFor(BindLifetime lifetime) -> sqlite3_destructor_type {
+  return lifetime == BindLifetime::Static ? SQLITE_STATIC : SQLITE_TRANSIENT;
+}
+
+} // namespace
+
+auto bindParameterNull(sqlite3_stmt *stmt, int idx) -> void {
+  bindChecked(stmt, idx, [&] { return sqlite3_bind_null(stmt, idx); });
 }
 
 template <>
-auto bindParameterValue(sqlite3_stmt *stmt, int idx,
-                        const std::string_view &value) -> void {
-  fmt::print("idx: {} value", idx);
-  const auto val = sqlite3_bind_text(stmt, idx, value.data(), value.size(),
-                                     SQLITE_TRANSIENT); // TODO Błędne kody
-  if (val != SQLITE_OK)
-    throw DatabaseRuntimeError(fmt::format("dupa {}", val));
+auto bindParameterValue(sqlite3_stmt *stmt, int idx, const int &value,
+                        BindLifetime) -> void {
+  bindChecked(stmt, idx, [&] { return sqlite3_bind_int64(stmt, idx, value); });
+}
+
+template <>
+auto bindParameterValue(sqlite3_stmt *stmt, int idx, const std::int64_t &value,
+                        BindLifetime) -> void {
+  bindChecked(stmt, idx, [&] { return sqlite3_bind_int64(stmt, idx, value); });
+}
+
+template <>
+auto bindParameterValue(sqlite3_stmt *stmt, int idx, const double &value,
+                        BindLifetime) -> void {
+  bindChecked(stmt, idx,
+              [&] { return sqlite3_bind_double(stmt, idx, value); });
 }
 
 template <>
-auto bindParameterValue(sqlite3_stmt *stmt, int idx, const char *const &value)
+auto bindParameterValue(sqlite3_stmt *stmt, int idx,
+                        const std::string_view &value, BindLifetime lifetime)
     -> void {
-  bindParameterValue(stmt, idx, std::string{value});
+  bindChecked(stmt, idx, [&] {
+    return sqlite3_bind_text64(stmt, idx, value.data(), value.size(),
+                               destructorFor(lifetime), SQLITE_UTF8);
+  });
+}
+
+template <>
+auto bindParameterValue(sqlite3_stmt *stmt, int idx, const std::string &value,
+                        BindLifetime lifetime) -> void {
+  bindParameterValue(stmt, idx, std::string_view{value}, lifetime);
+}
+
+template <>
+auto bindParameterValue(sqlite3_stmt *stmt, int idx, const char *const &value,
+                        BindLifetime lifetime) -> void {
+  bindParameterValue(stmt, idx, std::string_view{value}, lifetime);
 }
 
 template <>
 auto bindParameterValue(sqlite3_stmt *stmt, int idx,
-                        const std::vector<std::byte> &value) -> void {
-  fmt::print("idx: {} value", idx);
-  const auto val = sqlite3_bind_blob(stmt, idx, value.data(), value.size(),
-                                     SQLITE_TRANSIENT); // TODO Błędne kody
-  if (val != SQLITE_OK)
-    throw DatabaseRuntimeError(fmt::format("dupa {}", val));
+                        const std::vector<std::byte> &value,
+                        BindLifetime lifetime) -> void {
+  bindChecked(stmt, idx, [&] {
+    return sqlite3_bind_blob64(stmt, idx, value.data(), value.size(),
+                               destructorFor(lifetime));
+  });
 }
 
 } // namespace detail
 
-auto Query::getColumnIdxFromStatement(std::string_view fieldName) const -> int {
-  return m_impl->getIndex(fieldName);
+auto Query::column(std::string_view fieldName) const -> Column {
+  return Column{m_impl->getIndex(fieldName)};
+}
+
+auto Query::status() const -> StatementStatus {
+  return detail::statementStatus(getRawStatement());
+}
+
+auto Query::isNull(Column column) const -> bool {
+  return sqlite3_column_type(getRawStatement(), column.index) == SQLITE_NULL;
+}
+
+auto Query::columnCount() const -> int {
+  return sqlite3_column_count(getRawStatement());
 }
 
 auto Query::getRawStatement() const -> sqlite3_stmt * {
   return m_impl->getStatement();
 }
 
+auto Query::getStatementForBinding() -> sqlite3_stmt * {
+  return m_impl->getStatementForBinding();
+}
+
 auto Query::getParmameterIndex(std::string_view parameterName) const -> int {
-  const auto idx = sqlite3_bind_parameter_index(
-      getRawStatement(), fmt::format(":{}", parameterName).c_str());
+  // SQLite wants the ':' prefixed name as a C string; short names are built on
+  // the stack so that binding by name does not allocate.
+  char buffer[64];
+  auto formatted = std::string{};
+  auto name = static_cast<const char *>(buffer);
+  if (parameterName.size() + 2 <= sizeof(buffer)) {
+    buffer[0] = ':';
+    std::memcpy(buffer + 1, parameterName.data(), parameterName.size());
+    buffer[parameterName.size() + 1] = '\0';
+  } else {
+    formatted = fmt::format(":{}", parameterName);
+    name = formatted.c_str();
+  }
+
+  const auto idx = sqlite3_bind_parameter_index(getRawStatement(), name);
   if (!idx)
     throw NoSuchSqlParameter(parameterName);
 
   return idx;
 }
 
+auto Query::bindOwned(int idx, std::string &&value) -> void {
+  getStatementForBinding();
+  m_impl->bindOwned(idx, std::move(value));
+}
+
+auto Query::bindOwned(int idx, std::vector<std::byte> &&value) -> void {
+  getStatementForBinding();
+  m_impl->bindOwned(idx, std::move(value));
+}
+
+auto Query::bindOwned(int idx, OwnedBlob &&value) -> void {
+  const auto stmt = getStatementForBinding();
+  const auto size = value.size();
+  const auto destructor = value.destructor();
+  // SQLite calls the destructor even when binding fails.
+  const auto data = value.release();
+  detail::bindChecked(stmt, idx, [&] {
+    return sqlite3_bind_blob64(stmt, idx, data, size, destructor);
+  });
+}
+
+auto Query::parameter(std::string_view parameterName) const -> Parameter {
+  return Parameter{getParmameterIndex(parameterName)};
+}
+
+auto Query::checkSpec(const std::string_view *parameters,
+                      std::size_t parameterCount,
+                      const std::string_view *columns,
+                      std::size_t columnCount) const -> void {
+  // A cached statement is checked once per spec, not on every borrow.
+  auto &handle = m_impl->getStatementHandle();
+  if (handle.isSpecChecked(parameters, parameterCount, columns, columnCount))
+    return;
+
+  const auto stmt = getRawStatement();
+
+  if (sqlite3_bind_parameter_count(stmt) != static_cast<int>(parameterCount))
+    throw IncorrectQuerySql(fmt::format(
+        "Statement has {} parameters, spec declares {}",
+        sqlite3_bind_parameter_count(stmt), parameterCount));
+
+  for (std::size_t i = 0; i < parameterCount; ++i) {
+    const auto expected = static_cast<int>(i) + 1;
+    if (getParmameterIndex(parameters[i]) != expected)
+      throw IncorrectQuerySql(
+          fmt::format("Parameter '{}' is not parameter {} of the statement",
+                      parameters[i], expected));
+  }
+
+  if (sqlite3_column_count(stmt) != static_cast<int>(columnCount))
+    throw IncorrectQuerySql(
+        fmt::format("Statement has {} columns, spec declares {}",
+                    sqlite3_column_count(stmt), columnCount));
+
+  for (std::size_t i = 0; i < columnCount; ++i) {
+    if (m_impl->getIndex(columns[i]) != static_cast<int>(i))
+      throw IncorrectQuerySql(fmt::format(
+          "Column '{}' is not column {} of the statement", columns[i], i));
+  }
+
+  handle.markSpecChecked(parameters, parameterCount, columns, columnCount);
+}
+
 } // namespace Database
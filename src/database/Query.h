@@ -4,25 +4,72 @@
 #include <cinttypes>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "core/type_traits/is_optional_v.h"
+#include "database/ByteSpan.h"
 #include "database/Connection_fwd.h"
+#include "database/StatementSpec.h"
+#include "database/StatementStats.h"
+#include "database/Value.h"
 #include "database/database_export.h"
 #include "sqlite3.h"
 
 namespace Database {
 
+// How long SQLite may use a bound text or blob buffer.
+enum class BindLifetime {
+  // SQLite copies the value while binding.
+  Transient,
+  // No copy; the caller keeps the buffer alive and unchanged until the
+  // parameter is bound again, bindings are cleared or the Query is destroyed.
+  Static,
+};
+
+// Blob whose ownership passes to SQLite when bound. SQLite frees it with the
+// destructor once it no longer needs it, including when binding fails.
+class OwnedBlob {
+public:
+  using Destructor = void (*)(void *);
+
+  OwnedBlob(void *data, std::uint64_t size, Destructor destructor)
+      : m_data(data, destructor), m_size(size) {}
+
+  auto size() const -> std::uint64_t { return m_size; }
+  auto destructor() const -> Destructor { return m_data.get_deleter(); }
+  auto release() -> void * { return m_data.release(); }
+
+private:
+  std::unique_ptr<void, Destructor> m_data;
+  std::uint64_t m_size;
+};
+
 namespace detail {
 
 template <typename ValueT>
 auto getFromQuery(sqlite3_stmt *stmt, int idx) -> ValueT;
 
+// Reads std::pmr::string or std::pmr::vector<std::byte> allocated from
+// resource.
+template <typename ValueT>
+auto getFromQuery(sqlite3_stmt *stmt, int idx,
+                  std::pmr::memory_resource *resource) -> ValueT;
+
+// Copies a text or blob column into buffer, reusing its capacity. Returns
+// false (leaving buffer empty) for NULL.
+template <typename BufferT>
+auto getIntoBuffer(sqlite3_stmt *stmt, int idx, BufferT &buffer) -> bool;
+
 template <typename ValueT>
 inline auto getOptionalFromQuery(sqlite3_stmt *stmt, int idx) -> ValueT {
   if (sqlite3_column_type(stmt, idx) == SQLITE_NULL)
@@ -32,57 +79,297 @@ inline auto getOptionalFromQuery(sqlite3_stmt *stmt, int idx) -> ValueT {
 }
 
 template <typename ValueT>
-auto bindParameterValue(sqlite3_stmt *stmt, int idx, const ValueT &value)
+inline auto getOptionalFromQuery(sqlite3_stmt *stmt, int idx,
+                                 std::pmr::memory_resource *resource)
+    -> ValueT {
+  if (sqlite3_column_type(stmt, idx) == SQLITE_NULL)
+    return std::nullopt;
+
+  return getFromQuery<typename ValueT::value_type>(stmt, idx, resource);
+}
+
+template <typename ValueT>
+auto bindParameterValue(sqlite3_stmt *stmt, int idx, const ValueT &value,
+                        BindLifetime lifetime = BindLifetime::Transient)
     -> void;
 
+DATABASE_EXPORT auto bindParameterNull(sqlite3_stmt *stmt, int idx) -> void;
+
 template <typename ValueT>
 inline auto bindParameterOptionalValue(sqlite3_stmt *stmt, int idx,
-                                       ValueT&& value) -> void {
+                                       ValueT&& value,
+                                       BindLifetime lifetime) -> void {
   if (value)
-    bindParameterValue(stmt, idx, value.value());
+    bindParameterValue(stmt, idx, value.value(), lifetime);
   else
-    sqlite3_bind_null(stmt, idx);
+    bindParameterNull(stmt, idx);
 }
 
 } // namespace detail
 
+template <typename RowT> class RowMapper;
+template <typename RowT> class MappedRowRange;
+template <typename... ValueT> class ColumnBatch;
+
+struct QueryOptions {
+  // Borrow the statement from the connection's statement cache instead of
+  // preparing it for this Query alone.
+  bool useStatementCache = true;
+  // Holds the column names of a statement prepared for this Query alone
+  // and must outlive it. Cached statements outlive any Query, so their
+  // names always use the default resource.
+  std::pmr::memory_resource *memoryResource = nullptr;
+};
+
 class DATABASE_EXPORT Query {
 public:
-  Query(std::string_view sql, Connection &connection);
+  class RowIterator;
+  class RowRange;
+
+  Query(std::string_view sql, Connection &connection,
+        const QueryOptions &options = {});
+
+  // Prepares the statement of a spec and checks that its declared
+  // parameters and columns sit at the positions the handles refer to.
+  template <std::size_t ParameterCount, std::size_t ColumnCount>
+  Query(const StatementSpec<ParameterCount, ColumnCount> &spec,
+        Connection &connection, const QueryOptions &options = {})
+      : Query(spec.sql(), connection, options) {
+    checkSpec(spec.parameters().data(), ParameterCount, spec.columns().data(),
+              ColumnCount);
+  }
+
   virtual ~Query();
 
+  // Runs the statement up to its first row. A statement that was already
+  // executed is reset first, so the same Query can be re-executed with its
+  // current (or updated) bindings without being prepared again.
   auto execute() -> void;
 
+  // Rewinds the statement so it can be executed again. Bindings are kept.
+  auto reset() -> void;
+
+  // Sets all bound parameters back to NULL.
+  auto clearBindings() -> void;
+
+  // Moves the cursor to the next result row. The first call executes the
+  // statement; returns false once SQLITE_DONE is reached.
+  auto next() -> bool;
+
+  // Forward-only range over the rows starting at the current one. Rows are
+  // stepped lazily and read in place through the dereferenced Query.
+  auto rows() -> RowRange;
+
+  auto column(std::string_view fieldName) const -> Column;
+  auto columnCount() const -> int;
+  auto parameter(std::string_view parameterName) const -> Parameter;
+
+  // Besides owning types, std::string_view and ByteSpan can be read; they
+  // point into SQLite's row buffer and stay valid until the next step,
+  // reset or get of the same column as another type. Value reads a column
+  // as whatever storage class it holds.
   template <typename ValueT> auto get(std::string_view fieldName) -> ValueT {
+    return get<ValueT>(column(fieldName));
+  }
+
+  template <typename ValueT> auto get(Column column) -> ValueT {
     const auto stmt = getRawStatement();
-    const auto idx = getColumnIdxFromStatement(fieldName);
 
     if constexpr (Core::type_traits::is_optional_v<ValueT>)
-      return detail::getOptionalFromQuery<ValueT>(stmt, idx);
+      return detail::getOptionalFromQuery<ValueT>(stmt, column.index);
+    else
+      return detail::getFromQuery<ValueT>(stmt, column.index);
+  }
 
-    return detail::getFromQuery<ValueT>(stmt, idx);
+  // Reads std::pmr::string or std::pmr::vector<std::byte>, or optionals of
+  // them, allocated from resource, e.g. a monotonic buffer released once a
+  // whole batch of rows has been handled.
+  template <typename ValueT>
+  auto get(std::string_view fieldName, std::pmr::memory_resource *resource)
+      -> ValueT {
+    return get<ValueT>(column(fieldName), resource);
   }
 
   template <typename ValueT>
-  void set(std::string_view fieldName, ValueT&&value) {
-    const auto idx = getParmameterIndex(fieldName);
+  auto get(Column column, std::pmr::memory_resource *resource) -> ValueT {
     const auto stmt = getRawStatement();
 
+    if constexpr (Core::type_traits::is_optional_v<ValueT>)
+      return detail::getOptionalFromQuery<ValueT>(stmt, column.index,
+                                                  resource);
+    else
+      return detail::getFromQuery<ValueT>(stmt, column.index, resource);
+  }
+
+  // Reads the current row into a struct described by a RowMapping
+  // specialization; defined in RowMapping.h. Columns are looked up on every
+  // call, so loops should use rowsAs() or a RowMapper.
+  template <typename RowT> auto as() -> RowT;
+
+  // Like rows(), yielding mapped structs. Columns are resolved once.
+  template <typename RowT> auto rowsAs() -> MappedRowRange<RowT>;
+
+  // Appends the remaining rows as mapped structs and returns how many were
+  // added. Rows are emplaced first, so with a std::pmr::vector of
+  // allocator-aware structs every row and its strings come from the
+  // vector's resource and can be released in one go:
+  //
+  //   std::pmr::monotonic_buffer_resource arena;
+  //   std::pmr::vector<PmrSessionRow> rows{&arena};
+  //   query.fetchAllInto(rows);
+  template <typename RowT, typename AllocatorT>
+  auto fetchAllInto(std::vector<RowT, AllocatorT> &rows) -> std::size_t;
+
+  // Reads up to batchSize further rows into per-column arrays, columns 0,
+  // 1, ... as the given types; defined in ColumnBatch.h. Like next(), the
+  // first call executes the statement. The overload refilling a batch
+  // returns false once no rows are left.
+  template <typename... ValueT>
+  auto fetchColumns(std::size_t batchSize) -> ColumnBatch<ValueT...>;
+  template <typename... ValueT>
+  auto fetchColumns(ColumnBatch<ValueT...> &batch, std::size_t batchSize)
+      -> bool;
+
+  auto isNull(Column column) const -> bool;
+
+  // sqlite3_stmt_status counters of the underlying statement.
+  auto status() const -> StatementStatus;
+
+  // Reads a text (std::string) or blob (std::vector<std::byte>) column into
+  // caller provided storage so that a loop over rows does not allocate.
+  // The std::pmr variants keep allocating from their own resource. Returns
+  // false for NULL.
+  template <typename BufferT>
+  auto getInto(std::string_view fieldName, BufferT &buffer) -> bool {
+    return getInto(column(fieldName), buffer);
+  }
+
+  template <typename BufferT>
+  auto getInto(Column column, BufferT &buffer) -> bool {
+    return detail::getIntoBuffer(getRawStatement(), column.index, buffer);
+  }
+
+  // Binds a value. Text and blobs are copied unless lifetime is Static;
+  // std::string and std::vector<std::byte> rvalues are moved into the Query
+  // and OwnedBlob hands its buffer over to SQLite, neither copying.
+  template <typename ValueT>
+  void set(std::string_view fieldName, ValueT&&value,
+           BindLifetime lifetime = BindLifetime::Transient) {
+    set(parameter(fieldName), std::forward<ValueT>(value), lifetime);
+  }
+
+  template <typename ValueT>
+  void set(Parameter parameter, ValueT &&value,
+           BindLifetime lifetime = BindLifetime::Transient) {
+    const auto idx = parameter.index;
+    const auto stmt = getStatementForBinding();
+
     using UnRef = std::remove_reference_t<ValueT>;
+    using Plain = std::remove_cv_t<UnRef>;
+    constexpr auto isRvalue = !std::is_lvalue_reference_v<ValueT>;
 
-    if constexpr (Core::type_traits::is_optional_v<UnRef>)
-      detail::bindParameterOptionalValue(stmt, idx, value);
+    if constexpr (std::is_same_v<Plain, Value>) {
+      std::visit(
+          [&](auto &&alternative) {
+            set(parameter, std::forward<decltype(alternative)>(alternative),
+                lifetime);
+          },
+          std::forward<ValueT>(value));
+    } else if constexpr (std::is_same_v<Plain, std::nullptr_t>)
+      detail::bindParameterNull(stmt, idx);
+    else if constexpr (std::is_same_v<Plain, OwnedBlob>) {
+      static_assert(isRvalue, "OwnedBlob must be moved into set()");
+      bindOwned(idx, std::move(value));
+    } else if constexpr (isRvalue && (std::is_same_v<Plain, std::string> ||
+                                      std::is_same_v<Plain,
+                                                     std::vector<std::byte>>))
+      bindOwned(idx, std::move(value));
+    else if constexpr (Core::type_traits::is_optional_v<Plain>)
+      detail::bindParameterOptionalValue(stmt, idx, value, lifetime);
+    else if constexpr (std::is_array_v<UnRef>)
+      detail::bindParameterValue<const char *>(stmt, idx, value, lifetime);
     else
-      detail::bindParameterValue(stmt, idx, value);
+      detail::bindParameterValue(stmt, idx, value, lifetime);
+  }
+
+  // Binds the values to parameters 1, 2, ... in order, as set() does by
+  // handle, without looking up any name.
+  template <typename... ValueT> void bind(ValueT &&...values) {
+    [[maybe_unused]] auto index = 0;
+    (set(Parameter{++index}, std::forward<ValueT>(values)), ...);
+  }
+
+  // Reads columns 0, 1, ... of the current row as the given types.
+  template <typename... ValueT> auto fetch() -> std::tuple<ValueT...> {
+    return fetchRow<ValueT...>(std::index_sequence_for<ValueT...>{});
   }
 
 private:
+  template <typename... ValueT, std::size_t... Indices>
+  auto fetchRow(std::index_sequence<Indices...>) -> std::tuple<ValueT...> {
+    return {get<ValueT>(Column{static_cast<int>(Indices)})...};
+  }
+
+  auto start() -> bool;
   auto getRawStatement() const -> sqlite3_stmt *;
-  auto getColumnIdxFromStatement(std::string_view fieldName) const -> int;
+  auto getStatementForBinding() -> sqlite3_stmt *;
   auto getParmameterIndex(std::string_view parameterName) const -> int;
+  auto bindOwned(int idx, std::string &&value) -> void;
+  auto bindOwned(int idx, std::vector<std::byte> &&value) -> void;
+  auto bindOwned(int idx, OwnedBlob &&value) -> void;
+  auto checkSpec(const std::string_view *parameters, std::size_t parameterCount,
+                 const std::string_view *columns, std::size_t columnCount) const
+      -> void;
 
   class Impl;
   std::unique_ptr<Impl> m_impl;
 };
 
+class Query::RowIterator {
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = Query;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Query *;
+  using reference = Query &;
+
+  RowIterator() = default;
+  explicit RowIterator(Query *query) : m_query(query) {}
+
+  auto operator*() const -> Query & { return *m_query; }
+  auto operator->() const -> Query * { return m_query; }
+
+  auto operator++() -> RowIterator & {
+    if (!m_query->next())
+      m_query = nullptr;
+    return *this;
+  }
+  auto operator++(int) -> void { ++*this; }
+
+  friend auto operator==(const RowIterator &lhs, const RowIterator &rhs)
+      -> bool {
+    return lhs.m_query == rhs.m_query;
+  }
+  friend auto operator!=(const RowIterator &lhs, const RowIterator &rhs)
+      -> bool {
+    return !(lhs == rhs);
+  }
+
+private:
+  Query *m_query = nullptr;
+};
+
+class Query::RowRange {
+public:
+  explicit RowRange(Query &query) : m_query(query) {}
+
+  auto begin() -> RowIterator {
+    return m_query.start() ? RowIterator{&m_query} : RowIterator{};
+  }
+  auto end() -> RowIterator { return {}; }
+
+private:
+  Query &m_query;
+};
+
 } // namespace Database
\ No newline at end of file
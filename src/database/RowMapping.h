@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "database/Query.h"
+#include "database/StatementSpec.h"
+
+namespace Database {
+
+// Binds a result column name to a data member.
+template <typename RowT, typename MemberT> struct Field {
+  std::string_view name;
+  MemberT RowT::*member;
+};
+
+template <typename RowT, typename MemberT>
+constexpr auto field(std::string_view name, MemberT RowT::*member)
+    -> Field<RowT, MemberT> {
+  return {name, member};
+}
+
+// Specialize for each row struct, listing its fields once:
+//
+//   template <> struct Database::RowMapping<SessionRow> {
+//     static constexpr auto fields =
+//         std::tuple{Database::field("id", &SessionRow::id),
+//                    Database::field("user", &SessionRow::user)};
+//   };
+//
+// Members are read with Query::get, so std::optional members map nullable
+// columns. std::pmr::string and std::pmr::vector<std::byte> members keep
+// allocating from their own resource; see Query::fetchAllInto.
+template <typename RowT> struct RowMapping;
+
+namespace detail {
+
+// Members read in place with Query::getInto.
+template <typename MemberT>
+constexpr auto isBufferMember =
+    std::is_same_v<MemberT, std::string> ||
+    std::is_same_v<MemberT, std::vector<std::byte>> ||
+    std::is_same_v<MemberT, std::pmr::string> ||
+    std::is_same_v<MemberT, std::pmr::vector<std::byte>>;
+
+template <typename RowT, typename = void> constexpr auto hasRowMapping = false;
+
+template <typename RowT>
+constexpr auto
+    hasRowMapping<RowT, std::void_t<decltype(RowMapping<RowT>::fields)>> =
+        true;
+
+} // namespace detail
+
+// Column positions of a RowMapping resolved against one statement; reads
+// rows of that statement by index.
+template <typename RowT> class RowMapper {
+public:
+  static constexpr auto fieldCount = std::tuple_size_v<
+      std::remove_cv_t<decltype(RowMapping<RowT>::fields)>>;
+
+  explicit RowMapper(const Query &query)
+      : m_columns(resolve(query, std::make_index_sequence<fieldCount>{})) {}
+
+  auto read(Query &query) const -> RowT {
+    auto row = RowT{};
+    readInto(query, row);
+    return row;
+  }
+
+  // Overwrites every mapped member; text and blob members keep their
+  // capacity and allocator.
+  auto readInto(Query &query, RowT &row) const -> void {
+    readFields(query, row, std::make_index_sequence<fieldCount>{});
+  }
+
+private:
+  template <std::size_t... Indices>
+  static auto resolve(const Query &query, std::index_sequence<Indices...>)
+      -> std::array<Column, fieldCount> {
+    return {query.column(std::get<Indices>(RowMapping<RowT>::fields).name)...};
+  }
+
+  template <std::size_t... Indices>
+  auto readFields(Query &query, RowT &row,
+                  std::index_sequence<Indices...>) const -> void {
+    (readField(query, row, std::get<Indices>(RowMapping<RowT>::fields),
+               m_columns[Indices]),
+     ...);
+  }
+
+  template <typename MemberT>
+  static auto readField(Query &query, RowT &row,
+                        const Field<RowT, MemberT> &field, Column column)
+      -> void {
+    auto &member = row.*field.member;
+    if constexpr (detail::isBufferMember<MemberT>)
+      query.getInto(column, member);
+    else
+      member = query.get<MemberT>(column);
+  }
+
+  std::array<Column, fieldCount> m_columns;
+};
+
+// Input range of mapped rows. The struct is reused from row to row, so the
+// reference from operator* is only valid until the iterator advances.
+template <typename RowT> class MappedRowRange {
+public:
+  class Iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = RowT;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const RowT *;
+    using reference = const RowT &;
+
+    Iterator() = default;
+    Iterator(Query::RowIterator row, const RowMapper<RowT> &mapper)
+        : m_row(row), m_mapper(&mapper) {
+      read();
+    }
+
+    auto operator*() const -> const RowT & { return m_value; }
+    auto operator->() const -> const RowT * { return &m_value; }
+
+    auto operator++() -> Iterator & {
+      ++m_row;
+      read();
+      return *this;
+    }
+    auto operator++(int) -> void { ++*this; }
+
+    friend auto operator==(const Iterator &lhs, const Iterator &rhs) -> bool {
+      return lhs.m_row == rhs.m_row;
+    }
+    friend auto operator!=(const Iterator &lhs, const Iterator &rhs) -> bool {
+      return !(lhs == rhs);
+    }
+
+  private:
+    auto read() -> void {
+      if (m_row != Query::RowIterator{})
+        m_mapper->readInto(*m_row, m_value);
+    }
+
+    Query::RowIterator m_row;
+    const RowMapper<RowT> *m_mapper = nullptr;
+    RowT m_value{};
+  };
+
+  explicit MappedRowRange(Query &query)
+      : m_rows(query.rows()), m_mapper(query) {}
+
+  auto begin() -> Iterator { return Iterator{m_rows.begin(), m_mapper}; }
+  auto end() -> Iterator { return {}; }
+
+private:
+  Query::RowRange m_rows;
+  RowMapper<RowT> m_mapper;
+};
+
+template <typename RowT> auto Query::as() -> RowT {
+  return RowMapper<RowT>{*this}.read(*this);
+}
+
+template <typename RowT> auto Query::rowsAs() -> MappedRowRange<RowT> {
+  return MappedRowRange<RowT>{*this};
+}
+
+template <typename RowT, typename AllocatorT>
+auto Query::fetchAllInto(std::vector<RowT, AllocatorT> &rows)
+    -> std::size_t {
+  const auto mapper = RowMapper<RowT>{*this};
+  const auto before = rows.size();
+  for (auto &current : this->rows())
+    mapper.readInto(current, rows.emplace_back());
+  return rows.size() - before;
+}
+
+} // namespace Database
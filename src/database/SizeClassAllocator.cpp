@@ -0,0 +1,189 @@
+#include "SizeClassAllocator.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace {
+
+constexpr auto classCount = 48;
+constexpr auto largestClass = std::size_t{64} * 1024;
+constexpr auto maxCachedBytesPerClass = std::size_t{4} * 1024 * 1024;
+constexpr auto minCachedBlocksPerClass = std::size_t{16};
+// Usable size of the block, in front of what SQLite gets. Keeps SQLite's
+// required 8 byte alignment.
+constexpr auto headerSize = sizeof(std::uint64_t);
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+struct SizeClass {
+  std::mutex mutex;
+  FreeBlock *head = nullptr;
+  std::size_t blocks = 0;
+};
+
+struct Pool {
+  std::array<SizeClass, classCount> classes;
+  std::atomic<std::uint64_t> hits{0};
+  std::atomic<std::uint64_t> misses{0};
+  std::atomic<std::size_t> cachedBytes{0};
+};
+
+auto pool() -> Pool & {
+  static auto instance = Pool{};
+  return instance;
+}
+
+auto highestBit(std::size_t value) -> int {
+  auto bit = 0;
+  while (value >>= 1)
+    ++bit;
+  return bit;
+}
+
+auto roundUp(std::size_t size) -> std::size_t {
+  size = (std::max<std::size_t>(size, 1) + 7) & ~std::size_t{7};
+  const auto sizeClass = Database::detail::sizeClassOf(size);
+  return sizeClass < 0 ? size : Database::detail::sizeOfClass(sizeClass);
+}
+
+auto headerOf(void *memory) -> std::uint64_t * {
+  return reinterpret_cast<std::uint64_t *>(static_cast<char *>(memory) -
+                                           headerSize);
+}
+
+auto maxCachedBlocks(int sizeClass) -> std::size_t {
+  return std::max(maxCachedBytesPerClass /
+                      Database::detail::sizeOfClass(sizeClass),
+                  minCachedBlocksPerClass);
+}
+
+auto poolMalloc(int bytes) -> void * {
+  const auto size = roundUp(static_cast<std::size_t>(bytes));
+  const auto sizeClass = Database::detail::sizeClassOf(size);
+  auto &state = pool();
+
+  if (sizeClass >= 0) {
+    auto &freeList = state.classes[sizeClass];
+    const auto lock = std::lock_guard{freeList.mutex};
+    if (const auto block = freeList.head) {
+      freeList.head = block->next;
+      --freeList.blocks;
+      state.cachedBytes -= size;
+      ++state.hits;
+      return block;
+    }
+  }
+
+  ++state.misses;
+  const auto raw = static_cast<char *>(std::malloc(headerSize + size));
+  if (!raw)
+    return nullptr;
+  *reinterpret_cast<std::uint64_t *>(raw) = size;
+  return raw + headerSize;
+}
+
+auto poolFree(void *memory) -> void {
+  if (!memory)
+    return;
+  const auto header = headerOf(memory);
+  const auto size = static_cast<std::size_t>(*header);
+  const auto sizeClass = Database::detail::sizeClassOf(size);
+  auto &state = pool();
+
+  if (sizeClass >= 0) {
+    auto &freeList = state.classes[sizeClass];
+    const auto lock = std::lock_guard{freeList.mutex};
+    if (freeList.blocks < maxCachedBlocks(sizeClass)) {
+      freeList.head = new (memory) FreeBlock{freeList.head};
+      ++freeList.blocks;
+      state.cachedBytes += size;
+      return;
+    }
+  }
+  std::free(header);
+}
+
+auto poolSize(void *memory) -> int {
+  return memory ? static_cast<int>(*headerOf(memory)) : 0;
+}
+
+auto poolRealloc(void *memory, int bytes) -> void * {
+  const auto size = poolSize(memory);
+  if (roundUp(static_cast<std::size_t>(bytes)) ==
+      static_cast<std::size_t>(size))
+    return memory;
+
+  const auto resized = poolMalloc(bytes);
+  if (!resized)
+    return nullptr;
+  std::memcpy(resized, memory, std::min(size, bytes));
+  poolFree(memory);
+  return resized;
+}
+
+auto poolRoundup(int bytes) -> int {
+  return static_cast<int>(roundUp(static_cast<std::size_t>(bytes)));
+}
+
+auto poolInit(void *) -> int { return SQLITE_OK; }
+
+// Hands the free lists back to malloc.
+auto poolShutdown(void *) -> void {
+  auto &state = pool();
+  for (auto &freeList : state.classes) {
+    const auto lock = std::lock_guard{freeList.mutex};
+    while (const auto block = freeList.head) {
+      freeList.head = block->next;
+      state.cachedBytes -= *headerOf(block);
+      std::free(headerOf(block));
+    }
+    freeList.blocks = 0;
+  }
+}
+
+} // namespace
+
+namespace Database {
+
+auto sizeClassAllocator() -> sqlite3_mem_methods {
+  return {poolMalloc,  poolFree, poolRealloc,  poolSize,
+          poolRoundup, poolInit, poolShutdown, nullptr};
+}
+
+auto sizeClassAllocatorStats() -> SizeClassAllocatorStats {
+  const auto &state = pool();
+  return {state.hits.load(), state.misses.load(), state.cachedBytes.load()};
+}
+
+namespace detail {
+
+auto sizeClassOf(std::size_t size) -> int {
+  if (size <= 32)
+    return static_cast<int>((std::max<std::size_t>(size, 1) - 1) / 8);
+  if (size > largestClass)
+    return -1;
+
+  const auto exponent = highestBit(size - 1);
+  const auto quarter = static_cast<int>(((size - 1) >> (exponent - 2)) & 3);
+  return 4 + (exponent - 5) * 4 + quarter;
+}
+
+auto sizeOfClass(int sizeClass) -> std::size_t {
+  if (sizeClass < 4)
+    return static_cast<std::size_t>(sizeClass + 1) * 8;
+
+  const auto exponent = (sizeClass - 4) / 4 + 5;
+  const auto quarter = (sizeClass - 4) % 4;
+  return static_cast<std::size_t>(5 + quarter) << (exponent - 2);
+}
+
+} // namespace detail
+
+} // namespace Database
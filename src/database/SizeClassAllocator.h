@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sqlite3.h"
+
+#include "database/database_export.h"
+
+namespace Database {
+
+struct SizeClassAllocatorStats {
+  // Allocations served from a free list, and those that went to malloc.
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  // Bytes held in free lists.
+  std::size_t cachedBytes = 0;
+};
+
+// sqlite3_mem_methods that round requests up to 48 size classes (8 byte
+// steps up to 32 bytes, then four per power of two up to 64 KiB) and keep
+// freed blocks in per-class free lists for reuse instead of returning them
+// to malloc. Up to 4 MiB per class is retained; larger requests go straight
+// to malloc. Install it with configureMemory().
+DATABASE_EXPORT auto sizeClassAllocator() -> sqlite3_mem_methods;
+
+// Process wide counters of the allocator since the process started.
+DATABASE_EXPORT auto sizeClassAllocatorStats() -> SizeClassAllocatorStats;
+
+namespace detail {
+
+// Exposed for tests: the class of a rounded size, or -1 when above the
+// largest class, and the size of a class.
+DATABASE_EXPORT auto sizeClassOf(std::size_t size) -> int;
+DATABASE_EXPORT auto sizeOfClass(int sizeClass) -> std::size_t;
+
+} // namespace detail
+
+} // namespace Database
@@ -0,0 +1,76 @@
+#include "SlowQueryLog.h"
+
+#include "spdlog/async.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/spdlog.h"
+
+#include "database/StatementStats.h"
+
+namespace {
+
+constexpr auto defaultLoggerName = "database.slow_query";
+
+auto defaultLogger() -> std::shared_ptr<spdlog::logger> {
+  static const auto logger = [] {
+    if (auto existing = spdlog::get(defaultLoggerName))
+      return existing;
+    return spdlog::create_async<spdlog::sinks::stderr_color_sink_mt>(
+        defaultLoggerName);
+  }();
+  return logger;
+}
+
+} // namespace
+
+namespace Database::detail {
+
+SlowQueryLog::SlowQueryLog(const SlowQueryLogOptions &options)
+    : m_options(options) {
+  if (!m_options.logger)
+    m_options.logger = defaultLogger();
+}
+
+auto SlowQueryLog::attach(sqlite3 *connection) -> void {
+  auto events = static_cast<unsigned>(SQLITE_TRACE_PROFILE);
+  if (m_options.logStatements)
+    events |= SQLITE_TRACE_STMT;
+  sqlite3_trace_v2(connection, events, &SlowQueryLog::onTrace, this);
+}
+
+auto SlowQueryLog::detach(sqlite3 *connection) -> void {
+  sqlite3_trace_v2(connection, 0, nullptr, nullptr);
+}
+
+auto SlowQueryLog::onTrace(unsigned event, void *context, void *statement,
+                           void *detail) -> int {
+  const auto log = static_cast<SlowQueryLog *>(context);
+  const auto stmt = static_cast<sqlite3_stmt *>(statement);
+
+  if (event == SQLITE_TRACE_PROFILE)
+    log->profile(stmt, std::chrono::nanoseconds{
+                           *static_cast<const sqlite3_int64 *>(detail)});
+  else if (event == SQLITE_TRACE_STMT)
+    // Statement text, or "-- comment" for trigger bodies.
+    log->m_options.logger->trace("statement sql=\"{}\"",
+                                 static_cast<const char *>(detail));
+  return 0;
+}
+
+auto SlowQueryLog::profile(sqlite3_stmt *statement,
+                           std::chrono::nanoseconds duration) -> void {
+  auto &logger = *m_options.logger;
+  if (duration >= m_options.threshold) {
+    logger.warn("slow query duration_ns={} sql=\"{}\"", duration.count(),
+                normalizedSql(statement));
+    return;
+  }
+
+  const auto sampleEvery = m_options.sampleEvery;
+  if (sampleEvery != 0 &&
+      m_fastStatements.fetch_add(1, std::memory_order_relaxed) % sampleEvery ==
+          0)
+    logger.info("sampled query duration_ns={} sql=\"{}\"", duration.count(),
+                normalizedSql(statement));
+}
+
+} // namespace Database::detail
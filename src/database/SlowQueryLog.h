@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "database/database_export.h"
+#include "sqlite3.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Database {
+
+struct SlowQueryLogOptions {
+  // Statements running at least this long are logged as warnings.
+  std::chrono::nanoseconds threshold = std::chrono::milliseconds{50};
+  // Logs one in this many faster statements at info level; 0 logs none.
+  std::uint32_t sampleEvery = 0;
+  // Also logs the text of every statement as it starts, at trace level.
+  bool logStatements = false;
+  // Defaults to the shared asynchronous "database.slow_query" logger
+  // writing to stderr.
+  std::shared_ptr<spdlog::logger> logger;
+};
+
+namespace detail {
+
+// sqlite3_trace_v2 callback target of one connection. Statements below the
+// threshold cost a comparison and, when sampling, an atomic increment;
+// nothing is formatted unless logged.
+class DATABASE_EXPORT SlowQueryLog {
+public:
+  explicit SlowQueryLog(const SlowQueryLogOptions &options);
+
+  // Registers with the connection; replaces any previous trace callback.
+  auto attach(sqlite3 *connection) -> void;
+  static auto detach(sqlite3 *connection) -> void;
+
+private:
+  static auto onTrace(unsigned event, void *context, void *statement,
+                      void *detail) -> int;
+
+  auto profile(sqlite3_stmt *statement, std::chrono::nanoseconds duration)
+      -> void;
+
+  SlowQueryLogOptions m_options;
+  std::atomic<std::uint64_t> m_fastStatements{0};
+};
+
+} // namespace detail
+
+} // namespace Database
@@ -0,0 +1,193 @@
+#include "StatementCache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "database/StatementStats.h"
+
+namespace Database::detail {
+
+StatementCache::StatementCache(std::size_t capacity) {
+  m_stats.capacity = capacity;
+}
+
+StatementCache::~StatementCache() {
+  for (auto &entry : m_entries)
+    if (entry.borrower)
+      entry.borrower->detach();
+}
+
+auto StatementCache::acquire(std::string_view sql) -> StatementHandle {
+  const auto it = m_index.find(sql);
+  if (it == end(m_index) || it->second->borrowed) {
+    ++m_stats.misses;
+    return {};
+  }
+
+  ++m_stats.hits;
+  const auto entry = it->second;
+  m_entries.splice(begin(m_entries), m_entries, entry);
+  entry->borrowed = true;
+  return StatementHandle{*this, entry};
+}
+
+auto StatementCache::store(std::string_view sql, StatementPtr statement)
+    -> StatementHandle {
+  if (m_stats.capacity == 0 || m_index.count(sql))
+    return StatementHandle{std::move(statement)};
+
+  m_entries.emplace_front(sql, std::move(statement));
+  const auto entry = begin(m_entries);
+  entry->borrowed = true;
+  m_index.emplace(entry->sql, entry);
+  m_stats.size = m_entries.size();
+  evict();
+
+  return StatementHandle{*this, entry};
+}
+
+auto StatementCache::setCapacity(std::size_t capacity) -> void {
+  m_stats.capacity = capacity;
+  evict();
+}
+
+auto StatementCache::stats() const -> StatementCacheStats { return m_stats; }
+
+auto StatementCache::release(Entries::iterator entry) -> void {
+  const auto stmt = entry->statement.get();
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  entry->borrowed = false;
+  entry->borrower = nullptr;
+  evict();
+}
+
+auto StatementCache::evict() -> void {
+  // Lent statements stay put; they are evicted once handed back.
+  auto it = end(m_entries);
+  while (m_entries.size() > m_stats.capacity && it != begin(m_entries)) {
+    --it;
+    if (it->borrowed)
+      continue;
+
+    m_index.erase(it->sql);
+    it = m_entries.erase(it);
+    ++m_stats.evictions;
+  }
+  m_stats.size = m_entries.size();
+}
+
+StatementHandle::StatementHandle(StatementPtr statement,
+                                 std::pmr::memory_resource *columnNames)
+    : m_owned(std::move(statement)),
+      m_ownedColumns(std::in_place, m_owned.get(), columnNames) {}
+
+StatementHandle::StatementHandle(StatementCache &cache,
+                                 StatementCache::Entries::iterator entry)
+    : m_cache(&cache), m_entry(entry) {
+  m_entry->borrower = this;
+}
+
+StatementHandle::~StatementHandle() { reset(); }
+
+StatementHandle::StatementHandle(StatementHandle &&other) noexcept
+    : m_owned(std::move(other.m_owned)),
+      m_ownedColumns(std::move(other.m_ownedColumns)),
+      m_ownedNormalizedSql(std::exchange(other.m_ownedNormalizedSql, {})),
+      m_cache(std::exchange(other.m_cache, nullptr)), m_entry(other.m_entry) {
+  if (m_cache)
+    m_entry->borrower = this;
+}
+
+auto StatementHandle::operator=(StatementHandle &&other) noexcept
+    -> StatementHandle & {
+  if (this != &other) {
+    reset();
+    m_owned = std::move(other.m_owned);
+    if (other.m_ownedColumns)
+      m_ownedColumns.emplace(std::move(*other.m_ownedColumns));
+    m_ownedNormalizedSql = std::exchange(other.m_ownedNormalizedSql, {});
+    m_cache = std::exchange(other.m_cache, nullptr);
+    m_entry = other.m_entry;
+    if (m_cache)
+      m_entry->borrower = this;
+  }
+  return *this;
+}
+
+auto StatementHandle::get() const -> sqlite3_stmt * {
+  return m_cache ? m_entry->statement.get() : m_owned.get();
+}
+
+auto StatementHandle::columns() const -> const ColumnIndex & {
+  static const auto none = ColumnIndex{};
+  if (m_cache)
+    return m_entry->columns;
+  return m_ownedColumns ? *m_ownedColumns : none;
+}
+
+auto StatementHandle::isSpecChecked(const std::string_view *parameters,
+                                    std::size_t parameterCount,
+                                    const std::string_view *columns,
+                                    std::size_t columnCount) const -> bool {
+  if (!m_cache || !m_entry->checkedSpec ||
+      m_entry->checkedParameters != parameterCount ||
+      m_entry->checkedSpec->size() != parameterCount + columnCount)
+    return false;
+
+  const auto checked = m_entry->checkedSpec->begin();
+  return std::equal(parameters, parameters + parameterCount, checked) &&
+         std::equal(columns, columns + columnCount, checked + parameterCount);
+}
+
+auto StatementHandle::markSpecChecked(const std::string_view *parameters,
+                                      std::size_t parameterCount,
+                                      const std::string_view *columns,
+                                      std::size_t columnCount) -> void {
+  if (!m_cache)
+    return;
+
+  auto &checked = m_entry->checkedSpec.emplace();
+  checked.reserve(parameterCount + columnCount);
+  checked.assign(parameters, parameters + parameterCount);
+  checked.insert(end(checked), columns, columns + columnCount);
+  m_entry->checkedParameters = parameterCount;
+}
+
+auto StatementHandle::normalizedSql() -> std::string_view {
+  auto &normalized = m_cache ? m_entry->normalizedSql : m_ownedNormalizedSql;
+  if (!normalized)
+    normalized = detail::normalizedSql(get());
+  return *normalized;
+}
+
+auto StatementHandle::latencies(std::uint64_t thread) const
+    -> QueryLatencyRecorder * {
+  return m_cache && m_entry->latenciesThread == thread ? m_entry->latencies
+                                                       : nullptr;
+}
+
+auto StatementHandle::setLatencies(std::uint64_t thread,
+                                   QueryLatencyRecorder &recorder) -> void {
+  if (!m_cache)
+    return;
+  m_entry->latenciesThread = thread;
+  m_entry->latencies = &recorder;
+}
+
+auto StatementHandle::reset() -> void {
+  if (m_cache)
+    std::exchange(m_cache, nullptr)->release(m_entry);
+  m_owned.reset();
+  m_ownedColumns.reset();
+  m_ownedNormalizedSql.reset();
+}
+
+auto StatementHandle::detach() -> void {
+  m_owned = std::move(m_entry->statement);
+  m_ownedColumns.emplace(std::move(m_entry->columns));
+  m_ownedNormalizedSql = m_entry->normalizedSql;
+  m_cache = nullptr;
+}
+
+} // namespace Database::detail
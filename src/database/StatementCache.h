@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "sqlite3.h"
+
+#include "database/ColumnIndex.h"
+
+namespace Database {
+
+struct StatementCacheStats {
+  std::size_t capacity = 0;
+  std::size_t size = 0;
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t evictions = 0;
+};
+
+namespace detail {
+
+struct statement_deleter {
+  auto operator()(sqlite3_stmt *statement) -> void {
+    [[maybe_unused]] const auto rc = sqlite3_finalize(statement);
+  }
+};
+
+using StatementPtr = std::unique_ptr<sqlite3_stmt, statement_deleter>;
+
+class StatementHandle;
+struct QueryLatencyRecorder;
+
+// Bounded LRU of prepared statements keyed by their SQL text. A statement is
+// lent to one Query at a time and goes back to the cache, reset and with its
+// bindings cleared, when that Query is destroyed. Statements still lent out
+// when the cache is destroyed pass to their handles, so a Query outliving
+// its Connection finalizes its statement itself.
+class StatementCache {
+public:
+  static constexpr std::size_t defaultCapacity = 64;
+
+  explicit StatementCache(std::size_t capacity = defaultCapacity);
+  ~StatementCache();
+
+  StatementCache(const StatementCache &) = delete;
+  auto operator=(const StatementCache &) -> StatementCache & = delete;
+
+  // Borrows the statement prepared for sql. Returns an empty handle when it
+  // is not cached or already lent out.
+  auto acquire(std::string_view sql) -> StatementHandle;
+
+  // Caches a freshly prepared statement and lends it out. Statements that
+  // cannot be cached are returned in an owning handle.
+  auto store(std::string_view sql, StatementPtr statement) -> StatementHandle;
+
+  auto setCapacity(std::size_t capacity) -> void;
+  auto stats() const -> StatementCacheStats;
+
+private:
+  friend class StatementHandle;
+
+  struct Entry {
+    Entry(std::string_view sql, StatementPtr statement)
+        : sql{sql}, statement{std::move(statement)},
+          columns{this->statement.get()} {}
+
+    std::string sql;
+    StatementPtr statement;
+    ColumnIndex columns;
+    bool borrowed = false;
+    // Names of the last StatementSpec checked against the statement,
+    // parameters first.
+    std::optional<std::vector<std::string>> checkedSpec;
+    std::size_t checkedParameters = 0;
+    // Set on first use, see StatementHandle::normalizedSql().
+    std::optional<std::string_view> normalizedSql;
+    // Latency recorder of the statement on the thread with this
+    // ThreadLatencies id, so later Queries skip the lookup by SQL.
+    std::uint64_t latenciesThread = 0;
+    QueryLatencyRecorder *latencies = nullptr;
+    // Handle holding the statement while it is borrowed.
+    StatementHandle *borrower = nullptr;
+  };
+  using Entries = std::list<Entry>;
+
+  auto release(Entries::iterator entry) -> void;
+  auto evict() -> void;
+
+  Entries m_entries; // most recently used first
+  std::unordered_map<std::string_view, Entries::iterator> m_index;
+  StatementCacheStats m_stats;
+};
+
+// Statement owned by a Query: either borrowed from a StatementCache or
+// prepared just for that Query.
+class StatementHandle {
+public:
+  StatementHandle() = default;
+  // Column names of the statement are allocated from columnNames.
+  explicit StatementHandle(StatementPtr statement,
+                           std::pmr::memory_resource *columnNames =
+                               std::pmr::get_default_resource());
+  ~StatementHandle();
+
+  StatementHandle(StatementHandle &&other) noexcept;
+  auto operator=(StatementHandle &&other) noexcept -> StatementHandle &;
+
+  auto get() const -> sqlite3_stmt *;
+  auto columns() const -> const ColumnIndex &;
+  explicit operator bool() const { return get() != nullptr; }
+
+  // Whether a StatementSpec with these names was checked against the cached
+  // statement before. Statements prepared just for one Query are always
+  // checked.
+  auto isSpecChecked(const std::string_view *parameters,
+                     std::size_t parameterCount,
+                     const std::string_view *columns,
+                     std::size_t columnCount) const -> bool;
+  auto markSpecChecked(const std::string_view *parameters,
+                       std::size_t parameterCount,
+                       const std::string_view *columns,
+                       std::size_t columnCount) -> void;
+
+  // Normalized SQL of the statement, computed once per prepare and kept by
+  // SQLite until the statement is finalized.
+  auto normalizedSql() -> std::string_view;
+
+  // Latency recorder cached with the statement for the thread with this
+  // ThreadLatencies id; nullptr when there is none or it is not cached.
+  auto latencies(std::uint64_t thread) const -> QueryLatencyRecorder *;
+  auto setLatencies(std::uint64_t thread, QueryLatencyRecorder &recorder)
+      -> void;
+
+private:
+  friend class StatementCache;
+
+  StatementHandle(StatementCache &cache,
+                  StatementCache::Entries::iterator entry);
+
+  auto reset() -> void;
+  // Takes over the borrowed statement from a cache being destroyed.
+  auto detach() -> void;
+
+  StatementPtr m_owned;
+  // Replaced by emplacing, never assigned: assigning would copy the names
+  // into the resource of the old index.
+  std::optional<ColumnIndex> m_ownedColumns;
+  std::optional<std::string_view> m_ownedNormalizedSql;
+  StatementCache *m_cache = nullptr;
+  StatementCache::Entries::iterator m_entry;
+};
+
+} // namespace detail
+
+} // namespace Database
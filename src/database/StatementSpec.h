@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "database/Exceptions.h"
+
+namespace Database {
+
+// Position of a result column, resolved once with Query::column() or
+// StatementSpec::column() so that repeated reads skip the name lookup.
+struct Column {
+  int index;
+};
+
+// SQLite (1-based) index of a bound parameter.
+struct Parameter {
+  int index;
+};
+
+template <typename... NameT>
+constexpr auto names(NameT... values)
+    -> std::array<std::string_view, sizeof...(NameT)> {
+  return {std::string_view{values}...};
+}
+
+// SQL text together with its named parameters (in order of appearance,
+// without the ':' prefix) and result columns (in select order). Handles
+// taken from a constexpr spec are integer constants, and a misspelled name
+// fails to compile:
+//
+//   constexpr auto findSession = Database::StatementSpec{
+//       "select id, payload from session where id = :id",
+//       Database::names("id"), Database::names("id", "payload")};
+//   constexpr auto idParameter = findSession.parameter("id");
+//   constexpr auto payloadColumn = findSession.column("payload");
+//
+// Query checks the declaration against the prepared statement once.
+template <std::size_t ParameterCount, std::size_t ColumnCount>
+class StatementSpec {
+public:
+  constexpr StatementSpec(
+      std::string_view sql,
+      const std::array<std::string_view, ParameterCount> &parameters,
+      const std::array<std::string_view, ColumnCount> &columns)
+      : m_sql(sql), m_parameters(parameters), m_columns(columns) {}
+
+  constexpr auto sql() const -> std::string_view { return m_sql; }
+
+  constexpr auto parameters() const
+      -> const std::array<std::string_view, ParameterCount> & {
+    return m_parameters;
+  }
+
+  constexpr auto columns() const
+      -> const std::array<std::string_view, ColumnCount> & {
+    return m_columns;
+  }
+
+  constexpr auto parameter(std::string_view name) const -> Parameter {
+    for (std::size_t i = 0; i < ParameterCount; ++i)
+      if (m_parameters[i] == name)
+        return Parameter{static_cast<int>(i) + 1};
+
+    throw NoSuchSqlParameter(name);
+  }
+
+  constexpr auto column(std::string_view name) const -> Column {
+    for (std::size_t i = 0; i < ColumnCount; ++i)
+      if (m_columns[i] == name)
+        return Column{static_cast<int>(i)};
+
+    throw NoSuchColumn(name);
+  }
+
+private:
+  std::string_view m_sql;
+  std::array<std::string_view, ParameterCount> m_parameters;
+  std::array<std::string_view, ColumnCount> m_columns;
+};
+
+} // namespace Database
@@ -0,0 +1,114 @@
+#include "StatementStats.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "spdlog/fmt/fmt.h"
+
+namespace {
+
+auto counter(sqlite3_stmt *statement, int op) -> std::uint64_t {
+  return static_cast<std::uint64_t>(sqlite3_stmt_status(statement, op, 0));
+}
+
+auto toMicroseconds(std::chrono::nanoseconds duration) -> double {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+namespace Database {
+
+namespace detail {
+
+std::atomic<StatementStatsRegistry *> statementStatsRegistry{nullptr};
+
+auto statementStatus(sqlite3_stmt *statement) -> StatementStatus {
+  return {counter(statement, SQLITE_STMTSTATUS_FULLSCAN_STEP),
+          counter(statement, SQLITE_STMTSTATUS_SORT),
+          counter(statement, SQLITE_STMTSTATUS_AUTOINDEX),
+          counter(statement, SQLITE_STMTSTATUS_VM_STEP),
+          counter(statement, SQLITE_STMTSTATUS_RUN),
+          counter(statement, SQLITE_STMTSTATUS_MEMUSED)};
+}
+
+auto normalizedSql(sqlite3_stmt *statement) -> std::string_view {
+  if (const auto normalized = sqlite3_normalized_sql(statement))
+    return normalized;
+  return sqlite3_sql(statement);
+}
+
+} // namespace detail
+
+auto setStatementStatsRegistry(StatementStatsRegistry *registry) -> void {
+  detail::statementStatsRegistry.store(registry, std::memory_order_release);
+}
+
+auto StatementStatsRegistry::recordPrepare(std::string_view sql,
+                                           std::chrono::nanoseconds duration)
+    -> void {
+  const auto lock = std::lock_guard{m_mutex};
+  auto it = m_statements.find(sql);
+  if (it == m_statements.end())
+    it = m_statements.emplace(std::string{sql}, StatementStats{}).first;
+
+  ++it->second.prepares;
+  it->second.prepareTime += duration;
+}
+
+auto StatementStatsRegistry::recordRun(std::string_view sql,
+                                       const StatementRun &run) -> void {
+  const auto lock = std::lock_guard{m_mutex};
+  auto it = m_statements.find(sql);
+  if (it == m_statements.end())
+    it = m_statements.emplace(std::string{sql}, StatementStats{}).first;
+
+  auto &stats = it->second;
+  ++stats.runs;
+  stats.rows += run.rows;
+  stats.stepTime += run.stepTime;
+  stats.fullscanSteps += run.status.fullscanSteps;
+  stats.sorts += run.status.sorts;
+  stats.autoindexes += run.status.autoindexes;
+  stats.vmSteps += run.status.vmSteps;
+  stats.maxMemoryUsed = std::max(stats.maxMemoryUsed, run.status.memoryUsed);
+}
+
+auto StatementStatsRegistry::snapshot() const -> Snapshot {
+  const auto lock = std::lock_guard{m_mutex};
+  return m_statements;
+}
+
+auto StatementStatsRegistry::clear() -> void {
+  const auto lock = std::lock_guard{m_mutex};
+  m_statements.clear();
+}
+
+auto StatementStatsRegistry::dump() const -> std::string {
+  const auto statements = snapshot();
+
+  auto bySlowest = std::vector<const Snapshot::value_type *>{};
+  bySlowest.reserve(statements.size());
+  for (const auto &entry : statements)
+    bySlowest.push_back(&entry);
+  std::sort(begin(bySlowest), end(bySlowest), [](auto lhs, auto rhs) {
+    return lhs->second.stepTime > rhs->second.stepTime;
+  });
+
+  auto out = std::string{};
+  for (const auto entry : bySlowest) {
+    const auto &[sql, stats] = *entry;
+    out += fmt::format(
+        "runs={} rows={} step_us={:.1f} prepares={} prepare_us={:.1f} "
+        "fullscan_steps={} sorts={} autoindex={} vm_steps={} "
+        "max_mem={} sql=\"{}\"\n",
+        stats.runs, stats.rows, toMicroseconds(stats.stepTime),
+        stats.prepares, toMicroseconds(stats.prepareTime),
+        stats.fullscanSteps, stats.sorts, stats.autoindexes, stats.vmSteps,
+        stats.maxMemoryUsed, sql);
+  }
+  return out;
+}
+
+} // namespace Database
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "database/database_export.h"
+#include "sqlite3.h"
+
+namespace Database {
+
+// sqlite3_stmt_status counters of one prepared statement, accumulated over
+// its lifetime (shared by every Query borrowing it from the cache).
+struct StatementStatus {
+  // Steps of full table scans; high values point to a missing index.
+  std::uint64_t fullscanSteps = 0;
+  // Sort operations that no index could serve.
+  std::uint64_t sorts = 0;
+  // Rows inserted into automatic (transient) indexes.
+  std::uint64_t autoindexes = 0;
+  // Virtual machine operations executed.
+  std::uint64_t vmSteps = 0;
+  // Completed or interrupted runs of the statement.
+  std::uint64_t runs = 0;
+  // Heap bytes held by the statement right now.
+  std::uint64_t memoryUsed = 0;
+};
+
+// Totals for every statement with the same normalized SQL.
+struct StatementStats {
+  std::uint64_t prepares = 0;
+  std::chrono::nanoseconds prepareTime{};
+  std::uint64_t runs = 0;
+  std::uint64_t rows = 0;
+  std::chrono::nanoseconds stepTime{};
+  std::uint64_t fullscanSteps = 0;
+  std::uint64_t sorts = 0;
+  std::uint64_t autoindexes = 0;
+  std::uint64_t vmSteps = 0;
+  std::uint64_t maxMemoryUsed = 0;
+};
+
+// One execution of a statement, from its first step to its end or reset.
+struct StatementRun {
+  std::uint64_t rows = 0;
+  std::chrono::nanoseconds stepTime{};
+  // Counter deltas over the run (runs is 1); memoryUsed is the value at its
+  // end.
+  StatementStatus status;
+};
+
+// Aggregates prepares and runs of every Query per normalized SQL (literals
+// replaced by '?'), while installed with setStatementStatsRegistry.
+class DATABASE_EXPORT StatementStatsRegistry {
+public:
+  using Snapshot = std::map<std::string, StatementStats, std::less<>>;
+
+  auto recordPrepare(std::string_view sql, std::chrono::nanoseconds duration)
+      -> void;
+  auto recordRun(std::string_view sql, const StatementRun &run) -> void;
+
+  auto snapshot() const -> Snapshot;
+  auto clear() -> void;
+
+  // One line per statement, slowest total step time first.
+  auto dump() const -> std::string;
+
+private:
+  mutable std::mutex m_mutex;
+  Snapshot m_statements;
+};
+
+// Installs the process wide registry (nullptr disables collection). The
+// registry must outlive every statement run while it is installed.
+DATABASE_EXPORT auto
+setStatementStatsRegistry(StatementStatsRegistry *registry) -> void;
+
+namespace detail {
+
+extern DATABASE_EXPORT std::atomic<StatementStatsRegistry *>
+    statementStatsRegistry;
+
+DATABASE_EXPORT auto statementStatus(sqlite3_stmt *statement)
+    -> StatementStatus;
+
+// Normalized SQL of a statement, or its text when SQLite was built without
+// SQLITE_ENABLE_NORMALIZE.
+DATABASE_EXPORT auto normalizedSql(sqlite3_stmt *statement)
+    -> std::string_view;
+
+} // namespace detail
+
+} // namespace Database
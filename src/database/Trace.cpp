@@ -0,0 +1,17 @@
+#include "Trace.h"
+
+namespace Database {
+
+namespace detail {
+
+std::atomic<TraceSink *> traceSink{nullptr};
+
+} // namespace detail
+
+TraceSink::~TraceSink() {}
+
+auto setTraceSink(TraceSink *sink) -> void {
+  detail::traceSink.store(sink, std::memory_order_release);
+}
+
+} // namespace Database
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "database/database_export.h"
+#include "sqlite3.h"
+
+namespace Database {
+
+enum class TraceEvent { Prepare, Bind, Step };
+
+struct TraceRecord {
+  TraceEvent event;
+  sqlite3_stmt *statement;
+  // Parameter index for Bind, 0 otherwise.
+  int index;
+  int resultCode;
+  std::chrono::nanoseconds duration;
+};
+
+// Receives prepares, binds and steps of every Query. Called on the thread
+// running the statement; implementations must be thread safe.
+class DATABASE_EXPORT TraceSink {
+public:
+  virtual ~TraceSink();
+
+  virtual auto record(const TraceRecord &record) -> void = 0;
+};
+
+// Installs the process wide sink (nullptr disables tracing). The sink must
+// outlive every statement run while it is installed. With tracing off a
+// traced call costs one atomic load; building with
+// DATABASE_ENABLE_TRACING=OFF removes even that.
+DATABASE_EXPORT auto setTraceSink(TraceSink *sink) -> void;
+
+namespace detail {
+
+extern DATABASE_EXPORT std::atomic<TraceSink *> traceSink;
+
+// Runs action (returning an SQLite result code) and reports it to the
+// installed sink. statement is read after the action so that a prepare can
+// report the statement it created.
+template <typename ActionT>
+inline auto traced(TraceEvent event, sqlite3_stmt *const &statement, int index,
+                   ActionT &&action) -> int {
+#ifdef DATABASE_ENABLE_TRACING
+  if (const auto sink = traceSink.load(std::memory_order_acquire)) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto resultCode = action();
+    sink->record({event, statement, index, resultCode,
+                  std::chrono::steady_clock::now() - start});
+    return resultCode;
+  }
+#endif
+  return action();
+}
+
+} // namespace detail
+
+} // namespace Database
@@ -0,0 +1,115 @@
+#include "Transaction.h"
+
+#include <exception>
+#include <string_view>
+
+#include "spdlog/spdlog.h"
+
+#include "database/Connection.h"
+#include "database/Query.h"
+
+namespace {
+
+auto beginSql(Database::TransactionMode mode) -> std::string_view {
+  switch (mode) {
+  case Database::TransactionMode::Immediate:
+    return "begin immediate";
+  case Database::TransactionMode::Exclusive:
+    return "begin exclusive";
+  case Database::TransactionMode::Deferred:
+    break;
+  }
+  return "begin deferred";
+}
+
+// Nested savepoints share one name: SQLite resolves RELEASE and ROLLBACK TO
+// to the innermost savepoint of that name, and every statement stays cached.
+constexpr auto savepointSql = "savepoint database_savepoint";
+constexpr auto releaseSql = "release database_savepoint";
+constexpr auto rollbackToSql = "rollback to database_savepoint";
+
+auto run(Database::Connection &connection, std::string_view sql) -> void {
+  Database::Query{sql, connection}.execute();
+}
+
+} // namespace
+
+namespace Database {
+
+Transaction::Transaction(Connection &connection, TransactionMode mode)
+    : m_connection(connection),
+      m_uncaughtExceptions(std::uncaught_exceptions()) {
+  run(m_connection, beginSql(mode));
+}
+
+Transaction::~Transaction() {
+  if (!m_active)
+    return;
+
+  try {
+    if (std::uncaught_exceptions() > m_uncaughtExceptions)
+      rollback();
+    else
+      commit();
+  } catch (const std::exception &e) {
+    spdlog::error("Finishing transaction failed: {}", e.what());
+    try {
+      rollback();
+    } catch (const std::exception &rollbackError) {
+      spdlog::error("Rolling back transaction failed: {}",
+                    rollbackError.what());
+    }
+  }
+}
+
+auto Transaction::commit() -> void {
+  run(m_connection, "commit");
+  m_active = false;
+}
+
+auto Transaction::rollback() -> void {
+  m_active = false;
+  // Some errors make SQLite roll back on its own.
+  if (m_connection.isInTransaction())
+    run(m_connection, "rollback");
+}
+
+auto Transaction::isActive() const -> bool { return m_active; }
+
+Savepoint::Savepoint(Connection &connection)
+    : m_connection(connection),
+      m_uncaughtExceptions(std::uncaught_exceptions()) {
+  run(m_connection, savepointSql);
+}
+
+Savepoint::~Savepoint() {
+  if (!m_active)
+    return;
+
+  try {
+    if (std::uncaught_exceptions() > m_uncaughtExceptions)
+      rollback();
+    else
+      release();
+  } catch (const std::exception &e) {
+    spdlog::error("Finishing savepoint failed: {}", e.what());
+  }
+}
+
+auto Savepoint::release() -> void {
+  run(m_connection, releaseSql);
+  m_active = false;
+}
+
+auto Savepoint::rollback() -> void {
+  m_active = false;
+  if (!m_connection.isInTransaction())
+    return;
+
+  run(m_connection, rollbackToSql);
+  run(m_connection, releaseSql);
+}
+
+auto Savepoint::isActive() const -> bool { return m_active; }
+
+} // namespace Database
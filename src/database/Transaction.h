@@ -0,0 +1,52 @@
+#pragma once
+
+#include "database/Connection_fwd.h"
+#include "database/database_export.h"
+
+namespace Database {
+
+enum class TransactionMode { Deferred, Immediate, Exclusive };
+
+// Begins a transaction on construction. Leaving the scope commits it, or
+// rolls it back when the scope is left by an exception. A commit failing in
+// the destructor is logged and rolled back; call commit() to see the error.
+class DATABASE_EXPORT Transaction {
+public:
+  explicit Transaction(Connection &connection,
+                       TransactionMode mode = TransactionMode::Deferred);
+  virtual ~Transaction();
+
+  Transaction(const Transaction &) = delete;
+  auto operator=(const Transaction &) -> Transaction & = delete;
+
+  auto commit() -> void;
+  auto rollback() -> void;
+  auto isActive() const -> bool;
+
+private:
+  Connection &m_connection;
+  int m_uncaughtExceptions;
+  bool m_active = true;
+};
+
+// Nestable unit inside (or, on its own, as) a transaction. Same scope rules
+// as Transaction: released on normal exit, rolled back on exception.
+class DATABASE_EXPORT Savepoint {
+public:
+  explicit Savepoint(Connection &connection);
+  virtual ~Savepoint();
+
+  Savepoint(const Savepoint &) = delete;
+  auto operator=(const Savepoint &) -> Savepoint & = delete;
+
+  auto release() -> void;
+  auto rollback() -> void;
+  auto isActive() const -> bool;
+
+private:
+  Connection &m_connection;
+  int m_uncaughtExceptions;
+  bool m_active = true;
+};
+
+} // namespace Database
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace Database {
+
+// Dynamically typed SQL value, for parameters that are collected at runtime
+// or handed over to another thread before being bound.
+using Value = std::variant<std::nullptr_t, std::int64_t, double, std::string,
+                           std::vector<std::byte>>;
+
+} // namespace Database
@@ -0,0 +1,149 @@
+#include "WriteQueue.h"
+
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "database/Connection.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "database/Transaction.h"
+
+namespace Database {
+
+WriteQueue::WriteQueue(Connection &connection,
+                       const WriteQueueOptions &options)
+    : m_connection(connection), m_options(options),
+      m_writer([this] { run(); }) {}
+
+WriteQueue::~WriteQueue() {
+  m_stopping.store(true);
+  {
+    const auto lock = std::lock_guard{m_wakeMutex};
+    m_sleeping.store(false);
+  }
+  m_wake.notify_one();
+  m_writer.join();
+}
+
+auto WriteQueue::submit(std::string sql, std::vector<Value> parameters)
+    -> std::future<std::int64_t> {
+  if (m_stopping.load())
+    throw DatabaseRuntimeError("WriteQueue is stopping");
+
+  auto job = Job{std::move(sql), std::move(parameters), {}};
+  auto result = job.result.get_future();
+  m_jobs.push(std::move(job));
+
+  // Only a sleeping writer needs the (locking) wake-up.
+  if (m_sleeping.exchange(false)) {
+    const auto lock = std::lock_guard{m_wakeMutex};
+    m_wake.notify_one();
+  }
+  return result;
+}
+
+auto WriteQueue::stats() const -> WriteQueueStats {
+  return {m_jobCount.load(), m_failedJobCount.load(), m_commitCount.load()};
+}
+
+auto WriteQueue::run() -> void {
+  using Clock = std::chrono::steady_clock;
+  auto group = std::vector<Job>{};
+  group.reserve(m_options.maxBatchSize);
+
+  while (true) {
+    if (m_jobs.empty()) {
+      if (m_stopping.load())
+        return;
+      waitForJobs(Clock::time_point::max());
+      continue;
+    }
+
+    const auto deadline = Clock::now() + m_options.maxBatchLatency;
+    while (group.size() < m_options.maxBatchSize) {
+      if (auto job = m_jobs.pop()) {
+        group.push_back(std::move(*job));
+        continue;
+      }
+      if (m_stopping.load() || Clock::now() >= deadline)
+        break;
+      waitForJobs(deadline);
+    }
+
+    commitGroup(group);
+    group.clear();
+  }
+}
+
+auto WriteQueue::waitForJobs(std::chrono::steady_clock::time_point deadline)
+    -> void {
+  auto lock = std::unique_lock{m_wakeMutex};
+  m_sleeping.store(true);
+  // Re-checked under the lock: a producer that pushed before seeing the flag
+  // would not notify.
+  if (!m_jobs.empty() || m_stopping.load()) {
+    m_sleeping.store(false);
+    return;
+  }
+
+  const auto woken = [this] { return !m_sleeping.load(); };
+  if (deadline == std::chrono::steady_clock::time_point::max())
+    m_wake.wait(lock, woken);
+  else
+    m_wake.wait_until(lock, deadline, woken);
+  m_sleeping.store(false);
+}
+
+auto WriteQueue::commitGroup(std::vector<Job> &group) -> void {
+  auto changes = std::vector<std::optional<std::int64_t>>(group.size());
+  // Jobs whose future already holds their own error.
+  auto failed = std::vector<bool>(group.size());
+
+  try {
+    auto transaction = Transaction{m_connection, TransactionMode::Immediate};
+    for (std::size_t i = 0; i < group.size(); ++i) {
+      auto &job = group[i];
+      try {
+        auto savepoint = Savepoint{m_connection};
+        auto query = Query{job.sql, m_connection};
+        for (std::size_t p = 0; p < job.parameters.size(); ++p)
+          query.set(Parameter{static_cast<int>(p) + 1},
+                    std::move(job.parameters[p]));
+        while (query.next()) {
+        }
+        changes[i] = m_connection.changes();
+        savepoint.release();
+      } catch (...) {
+        ++m_failedJobCount;
+        job.result.set_exception(std::current_exception());
+        failed[i] = true;
+      }
+      // A job may end the transaction itself (INSERT OR ROLLBACK, COMMIT);
+      // the rest of the group must not run in autocommit.
+      if (!m_connection.isInTransaction())
+        throw DatabaseRuntimeError("A job ended the group transaction");
+    }
+    transaction.commit();
+  } catch (...) {
+    // The group never became durable, or never started: fail every job
+    // still waiting, including those that never ran.
+    m_jobCount += group.size();
+    for (std::size_t i = 0; i < group.size(); ++i)
+      if (!failed[i]) {
+        ++m_failedJobCount;
+        group[i].result.set_exception(std::current_exception());
+      }
+    return;
+  }
+
+  // Counted before fulfilling, so a caller woken by its future sees itself
+  // in stats().
+  m_jobCount += group.size();
+  ++m_commitCount;
+  for (std::size_t i = 0; i < group.size(); ++i)
+    if (changes[i])
+      group[i].result.set_value(*changes[i]);
+}
+
+} // namespace Database
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "database/Connection_fwd.h"
+#include "database/MpscQueue.h"
+#include "database/Value.h"
+#include "database/database_export.h"
+
+namespace Database {
+
+struct WriteQueueOptions {
+  // A group is committed once it holds this many jobs...
+  std::size_t maxBatchSize = 256;
+  // ...or this long after its first job arrived.
+  std::chrono::microseconds maxBatchLatency{2000};
+};
+
+struct WriteQueueStats {
+  std::uint64_t jobs = 0;
+  std::uint64_t failedJobs = 0;
+  std::uint64_t commits = 0;
+};
+
+// Runs write statements on a dedicated thread, committing them in groups so
+// that many small writes share one transaction and one journal sync. Each
+// job runs in its own savepoint: a failing job only fails its own future.
+// Futures are fulfilled after the group is committed, with the number of
+// rows the job changed.
+//
+// The connection is used exclusively by the writer thread until the queue
+// is destroyed; the destructor finishes every queued job.
+class DATABASE_EXPORT WriteQueue {
+public:
+  WriteQueue(Connection &connection, const WriteQueueOptions &options = {});
+  virtual ~WriteQueue();
+
+  WriteQueue(const WriteQueue &) = delete;
+  auto operator=(const WriteQueue &) -> WriteQueue & = delete;
+
+  // Parameters are bound positionally. Safe to call from any thread.
+  auto submit(std::string sql, std::vector<Value> parameters = {})
+      -> std::future<std::int64_t>;
+
+  auto stats() const -> WriteQueueStats;
+
+private:
+  struct Job {
+    std::string sql;
+    std::vector<Value> parameters;
+    std::promise<std::int64_t> result;
+  };
+
+  auto run() -> void;
+  auto waitForJobs(std::chrono::steady_clock::time_point deadline) -> void;
+  auto commitGroup(std::vector<Job> &group) -> void;
+
+  Connection &m_connection;
+  WriteQueueOptions m_options;
+  detail::MpscQueue<Job> m_jobs;
+
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wake;
+  std::atomic<bool> m_sleeping{false};
+  std::atomic<bool> m_stopping{false};
+
+  std::atomic<std::uint64_t> m_jobCount{0};
+  std::atomic<std::uint64_t> m_failedJobCount{0};
+  std::atomic<std::uint64_t> m_commitCount{0};
+
+  std::thread m_writer;
+};
+
+} // namespace Database
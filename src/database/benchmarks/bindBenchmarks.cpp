@@ -0,0 +1,123 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "sqlite3.h"
+
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/StatementSpec.h"
+#include "database/Trace.h"
+
+namespace {
+
+constexpr auto bindSpec =
+    Database::StatementSpec{R"sql(select :value 'value')sql",
+                            Database::names("value"), Database::names("value")};
+constexpr auto valueParameter = bindSpec.parameter("value");
+
+class NullSink : public Database::TraceSink {
+public:
+  auto record(const Database::TraceRecord &) -> void override {}
+};
+
+static void bind_rawSqlite(benchmark::State &state) {
+  sqlite3 *db;
+  sqlite3_open(":memory:", &db);
+  sqlite3_stmt *stmt;
+  sqlite3_prepare_v2(db, bindSpec.sql().data(), bindSpec.sql().size(), &stmt,
+                     nullptr);
+  int64_t value = 0;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(sqlite3_bind_int64(stmt, 1, value++));
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+}
+BENCHMARK(bind_rawSqlite);
+
+static void bind_query(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{bindSpec, conn};
+  auto value = 0;
+  for (auto _ : state)
+    query.set(valueParameter, value++);
+}
+BENCHMARK(bind_query);
+
+static void bind_queryTraced(benchmark::State &state) {
+  auto sink = NullSink{};
+  auto conn = Database::Connection{};
+  auto query = Database::Query{bindSpec, conn};
+  Database::setTraceSink(&sink);
+  auto value = 0;
+  for (auto _ : state)
+    query.set(valueParameter, value++);
+  Database::setTraceSink(nullptr);
+}
+BENCHMARK(bind_queryTraced);
+
+// Binds one value of each type by handle.
+template <typename ValueT>
+static void bind_type(benchmark::State &state, ValueT value,
+                      Database::BindLifetime lifetime) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{bindSpec, conn};
+  for (auto _ : state)
+    query.set(valueParameter, value, lifetime);
+}
+BENCHMARK_CAPTURE(bind_type, int, 7, Database::BindLifetime::Transient);
+BENCHMARK_CAPTURE(bind_type, int64, std::int64_t{1} << 40,
+                  Database::BindLifetime::Transient);
+BENCHMARK_CAPTURE(bind_type, double, 1.5, Database::BindLifetime::Transient);
+BENCHMARK_CAPTURE(bind_type, textTransient, std::string(64, 'x'),
+                  Database::BindLifetime::Transient);
+BENCHMARK_CAPTURE(bind_type, textStatic, std::string(64, 'x'),
+                  Database::BindLifetime::Static);
+BENCHMARK_CAPTURE(bind_type, blobTransient,
+                  std::vector<std::byte>(64, std::byte{1}),
+                  Database::BindLifetime::Transient);
+BENCHMARK_CAPTURE(bind_type, null, std::optional<int>{},
+                  Database::BindLifetime::Transient);
+
+constexpr auto fiveColumnSql =
+    R"sql(select :a 'a', :b 'b', :c 'c', :d 'd', :e 'e')sql";
+
+static void bindFetch_byName(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{fiveColumnSql, conn};
+  std::int64_t value = 0;
+  for (auto _ : state) {
+    query.set("a", value++);
+    query.set("b", 1.5);
+    query.set("c", "text");
+    query.set("d", value);
+    query.set("e", std::optional<double>{});
+    query.execute();
+    benchmark::DoNotOptimize(query.get<std::int64_t>("a"));
+    benchmark::DoNotOptimize(query.get<double>("b"));
+    benchmark::DoNotOptimize(query.get<std::string_view>("c"));
+    benchmark::DoNotOptimize(query.get<std::int64_t>("d"));
+    benchmark::DoNotOptimize(query.get<std::optional<double>>("e"));
+  }
+}
+BENCHMARK(bindFetch_byName);
+
+static void bindFetch_positional(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{fiveColumnSql, conn};
+  std::int64_t value = 0;
+  for (auto _ : state) {
+    query.bind(value++, 1.5, "text", value, std::optional<double>{});
+    query.execute();
+    benchmark::DoNotOptimize(
+        query.fetch<std::int64_t, double, std::string_view, std::int64_t,
+                    std::optional<double>>());
+  }
+}
+BENCHMARK(bindFetch_positional);
+
+} // namespace
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "database/BulkInserter.h"
+#include "database/Connection.h"
+#include "database/Query.h"
+
+namespace {
+
+constexpr auto databaseFile = "bulk_insert_benchmark.db3";
+constexpr auto insertSql =
+    R"sql(insert into session (id, payload) values (:id, :payload))sql";
+
+class SessionFile : public benchmark::Fixture {
+public:
+  void SetUp(const benchmark::State &) override {
+    std::filesystem::remove(databaseFile);
+    m_conn = std::make_unique<Database::Connection>(databaseFile);
+    Database::Query{
+        R"sql(create table session (id integer primary key, payload text))sql",
+        *m_conn}
+        .execute();
+  }
+
+  void TearDown(const benchmark::State &) override {
+    m_conn.reset();
+    std::filesystem::remove(databaseFile);
+  }
+
+protected:
+  auto clear() -> void {
+    Database::Query{R"sql(delete from session)sql", *m_conn}.execute();
+  }
+
+  std::unique_ptr<Database::Connection> m_conn;
+};
+
+BENCHMARK_DEFINE_F(SessionFile, insert_autocommit)(benchmark::State &state) {
+  const auto payload = std::string(256, 'x');
+  for (auto _ : state) {
+    auto query = Database::Query{insertSql, *m_conn};
+    for (auto i = 0; i < state.range(0); ++i) {
+      query.set("id", i);
+      query.set("payload", payload);
+      query.execute();
+    }
+    state.PauseTiming();
+    clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(SessionFile, insert_autocommit)->Arg(100);
+
+BENCHMARK_DEFINE_F(SessionFile, insert_bulk)(benchmark::State &state) {
+  const auto payload = std::string(256, 'x');
+  for (auto _ : state) {
+    auto inserter = Database::BulkInserter{*m_conn, insertSql};
+    for (auto i = 0; i < state.range(0); ++i)
+      inserter.insert(i, payload);
+    inserter.finish();
+    state.PauseTiming();
+    clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(SessionFile, insert_bulk)->Arg(100)->Arg(100000);
+
+} // namespace
@@ -0,0 +1,111 @@
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "database/Connection.h"
+#include "database/ConnectionOptions.h"
+#include "database/Query.h"
+
+namespace {
+
+constexpr auto databaseFile = "connection_options_benchmark.db3";
+
+auto profile(int64_t idx) -> Database::ConnectionOptions {
+  auto options = Database::ConnectionOptions{};
+  switch (idx) {
+  case 1:
+    options.journalMode = Database::JournalMode::Wal;
+    break;
+  case 2:
+    options.journalMode = Database::JournalMode::Wal;
+    options.synchronous = Database::Synchronous::Normal;
+    break;
+  case 3:
+    options = Database::ConnectionOptions::highThroughput();
+    break;
+  default:
+    break;
+  }
+  return options;
+}
+
+constexpr auto profileNames =
+    std::array{"default", "wal", "wal_normal", "high_throughput"};
+
+auto removeDatabase() -> void {
+  for (const auto suffix : {"", "-wal", "-shm", "-journal"})
+    std::filesystem::remove(std::string{databaseFile} + suffix);
+}
+
+auto openSessionTable(int64_t profileIdx)
+    -> std::unique_ptr<Database::Connection> {
+  removeDatabase();
+  auto conn =
+      std::make_unique<Database::Connection>(databaseFile, profile(profileIdx));
+  Database::Query{
+      R"sql(create table session (id integer primary key, payload text))sql",
+      *conn}
+      .execute();
+  return conn;
+}
+
+// One autocommitted single-row transaction per iteration.
+static void options_write(benchmark::State &state) {
+  auto connection = openSessionTable(state.range(0));
+  auto &conn = *connection;
+  {
+    auto insert = Database::Query{
+        R"sql(insert into session (payload) values (:payload))sql", conn};
+    const auto payload = std::string(256, 'x');
+    for (auto _ : state) {
+      insert.set("payload", payload, Database::BindLifetime::Static);
+      insert.execute();
+    }
+  }
+  state.SetLabel(profileNames[state.range(0)]);
+  state.SetItemsProcessed(state.iterations());
+  connection.reset();
+  removeDatabase();
+}
+BENCHMARK(options_write)->DenseRange(0, 3);
+
+static void options_read(benchmark::State &state) {
+  constexpr auto rowCount = 10000;
+  auto connection = openSessionTable(state.range(0));
+  auto &conn = *connection;
+  {
+    auto insert = Database::Query{
+        R"sql(insert into session (id, payload) values (:id, :payload))sql",
+        conn};
+    Database::Query{"begin", conn}.execute();
+    for (auto i = 0; i < rowCount; ++i) {
+      insert.set("id", i);
+      insert.set("payload", std::string(256, 'x'));
+      insert.execute();
+    }
+    Database::Query{"commit", conn}.execute();
+  }
+
+  {
+    auto lookup = Database::Query{
+        R"sql(select payload from session where id = :id)sql", conn};
+    auto id = 0;
+    for (auto _ : state) {
+      lookup.set("id", id++ % rowCount);
+      lookup.execute();
+      benchmark::DoNotOptimize(
+          lookup.get<std::string_view>(Database::Column{0}));
+    }
+  }
+  state.SetLabel(profileNames[state.range(0)]);
+  state.SetItemsProcessed(state.iterations());
+  connection.reset();
+  removeDatabase();
+}
+BENCHMARK(options_read)->DenseRange(0, 3);
+
+} // namespace
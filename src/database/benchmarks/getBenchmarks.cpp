@@ -0,0 +1,41 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "database/ByteSpan.h"
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/Value.h"
+
+namespace {
+
+// Columns: int, int64, real, text, blob, null.
+constexpr auto typedRowSql =
+    R"sql(select 7, 1099511627776, 1.5, 'a short session payload',
+                 randomblob(64), null)sql";
+
+// Reads column state.range(0) of a single row repeatedly, by handle.
+template <typename ValueT> static void get_column(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{typedRowSql, conn};
+  query.execute();
+  const auto column = Database::Column{static_cast<int>(state.range(0))};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(query.get<ValueT>(column));
+}
+BENCHMARK_TEMPLATE(get_column, int)->Arg(0);
+BENCHMARK_TEMPLATE(get_column, std::int64_t)->Arg(1);
+BENCHMARK_TEMPLATE(get_column, double)->Arg(2);
+BENCHMARK_TEMPLATE(get_column, std::string)->Arg(3);
+BENCHMARK_TEMPLATE(get_column, std::string_view)->Arg(3);
+BENCHMARK_TEMPLATE(get_column, std::vector<std::byte>)->Arg(4);
+BENCHMARK_TEMPLATE(get_column, Database::ByteSpan)->Arg(4);
+BENCHMARK_TEMPLATE(get_column, std::optional<std::int64_t>)->Arg(5);
+BENCHMARK_TEMPLATE(get_column, Database::Value)->Arg(3);
+
+} // namespace
@@ -0,0 +1,20 @@
+#include "benchmark/benchmark.h"
+
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/isTableExist.h"
+
+namespace {
+
+static void isTableExist(benchmark::State &state, const char *table) {
+  auto conn = Database::Connection{};
+  Database::Query{R"sql(create table session (id integer primary key))sql",
+                  conn}
+      .execute();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Database::isTableExist(conn, table));
+}
+BENCHMARK_CAPTURE(isTableExist, existing, "session");
+BENCHMARK_CAPTURE(isTableExist, missing, "missing");
+
+} // namespace
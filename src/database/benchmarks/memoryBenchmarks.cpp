@@ -0,0 +1,127 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "sqlite3.h"
+
+#include "database/Connection.h"
+#include "database/MemoryConfig.h"
+#include "database/Query.h"
+#include "database/SizeClassAllocator.h"
+
+// Allocator churn of session lookups under different SQLite memory setups.
+// configureMemory() needs every connection closed, so these run in their
+// own executable and open their connection per benchmark.
+
+namespace {
+
+enum Setup : std::int64_t { Default, Lookaside, Pool, PoolAndPageCache };
+
+// Counts calls reaching the installed allocator.
+sqlite3_mem_methods countedAllocator{};
+std::atomic<std::uint64_t> allocatorCalls{0};
+
+auto countingAllocator(const sqlite3_mem_methods &allocator)
+    -> sqlite3_mem_methods {
+  countedAllocator = allocator;
+  auto counting = allocator;
+  counting.xMalloc = [](int bytes) {
+    ++allocatorCalls;
+    return countedAllocator.xMalloc(bytes);
+  };
+  counting.xRealloc = [](void *memory, int bytes) {
+    ++allocatorCalls;
+    return countedAllocator.xRealloc(memory, bytes);
+  };
+  return counting;
+}
+
+auto sqliteDefaultAllocator() -> sqlite3_mem_methods {
+  // Only filled in once SQLite was initialized, and only readable while it
+  // is shut down.
+  sqlite3_initialize();
+  sqlite3_shutdown();
+  auto methods = sqlite3_mem_methods{};
+  sqlite3_config(SQLITE_CONFIG_GETMALLOC, &methods);
+  return methods;
+}
+
+auto memoryOptions(Setup setup) -> Database::MemoryOptions {
+  static const auto systemAllocator = sqliteDefaultAllocator();
+  auto options = Database::MemoryOptions{};
+  const auto pooled = setup == Pool || setup == PoolAndPageCache;
+  options.allocator = countingAllocator(
+      pooled ? Database::sizeClassAllocator() : systemAllocator);
+  if (setup == PoolAndPageCache)
+    options.pageCache = Database::PageCacheOptions{4096, 256};
+  return options;
+}
+
+auto connectionOptions(Setup setup) -> Database::ConnectionOptions {
+  alignas(8) static std::array<std::byte, 512 * 256> lookasideBuffer;
+  auto options = Database::ConnectionOptions{};
+  if (setup == Lookaside)
+    options.lookaside =
+        Database::LookasideOptions{512, 256, lookasideBuffer.data()};
+  return options;
+}
+
+// Point lookups preparing their statement every time, as a request handler
+// without a statement cache would.
+void session_lookup(benchmark::State &state) {
+  const auto setup = static_cast<Setup>(state.range(0));
+  Database::configureMemory(memoryOptions(setup));
+  {
+    auto conn = Database::Connection{":memory:", connectionOptions(setup)};
+    Database::Query{
+        R"sql(create table session (id integer primary key, user text, payload text))sql",
+        conn}
+        .execute();
+    Database::Query{
+        R"sql(insert into session
+              with recursive ids(id) as
+                (select 0 union all select id + 1 from ids where id < 9999)
+              select id, 'user' || id, 'payload' from ids)sql",
+        conn}
+        .execute();
+
+    const auto options = Database::QueryOptions{false};
+    const auto callsBefore = allocatorCalls.load();
+    const auto poolBefore = Database::sizeClassAllocatorStats();
+    auto id = 0;
+    for (auto _ : state) {
+      auto query = Database::Query{
+          R"sql(select user, payload from session where id = ?)sql", conn,
+          options};
+      query.bind(id++ % 10000);
+      query.next();
+      benchmark::DoNotOptimize(query.get<std::string>(Database::Column{0}));
+    }
+
+    const auto iterations = static_cast<double>(state.iterations());
+    const auto allocations =
+        (allocatorCalls.load() - callsBefore) / iterations;
+    const auto pooled = setup == Pool || setup == PoolAndPageCache;
+    state.counters["allocs/lookup"] = allocations;
+    // Without the pool every allocation is a malloc.
+    state.counters["mallocs/lookup"] =
+        pooled ? (Database::sizeClassAllocatorStats().misses -
+                  poolBefore.misses) /
+                     iterations
+               : allocations;
+    state.counters["lookaside_hits"] =
+        static_cast<double>(conn.stats().lookasideHits);
+  }
+  Database::configureMemory({});
+}
+BENCHMARK(session_lookup)
+    ->ArgName("setup")
+    ->Arg(Default)
+    ->Arg(Lookaside)
+    ->Arg(Pool)
+    ->Arg(PoolAndPageCache);
+
+} // namespace
@@ -0,0 +1,112 @@
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+#include "database/Connection.h"
+#include "database/Metrics.h"
+#include "database/Query.h"
+#include "database/StatementStats.h"
+
+namespace {
+
+constexpr auto lookupSql =
+    R"sql(select id, payload from session where id = :id)sql";
+
+class SessionRows : public benchmark::Fixture {
+public:
+  void SetUp(const benchmark::State &) override {
+    Database::Query{
+        R"sql(create table if not exists session (id integer primary key, payload text))sql",
+        m_conn}
+        .execute();
+    Database::Query{R"sql(delete from session)sql", m_conn}.execute();
+    Database::Query{
+        R"sql(insert into session
+              with recursive ids(id) as
+                (select 0 union all select id + 1 from ids where id < 9999)
+              select id, 'payload' from ids)sql",
+        m_conn}
+        .execute();
+  }
+
+protected:
+  Database::Connection m_conn;
+};
+
+BENCHMARK_DEFINE_F(SessionRows, prepare_uncached)(benchmark::State &state) {
+  const auto options = Database::QueryOptions{false};
+  for (auto _ : state)
+    Database::Query{lookupSql, m_conn, options};
+}
+BENCHMARK_REGISTER_F(SessionRows, prepare_uncached);
+
+BENCHMARK_DEFINE_F(SessionRows, prepare_cached)(benchmark::State &state) {
+  for (auto _ : state)
+    Database::Query{lookupSql, m_conn};
+}
+BENCHMARK_REGISTER_F(SessionRows, prepare_cached);
+
+// Steps over the first state.range(0) rows of a table scan.
+BENCHMARK_DEFINE_F(SessionRows, step)(benchmark::State &state) {
+  auto query = Database::Query{
+      R"sql(select id from session limit :limit)sql", m_conn};
+  query.bind(state.range(0));
+  for (auto _ : state) {
+    while (query.next()) {
+    }
+    query.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(SessionRows, step)->Arg(1)->Arg(100)->Arg(10000);
+
+// Point lookups with the statement stats registry installed.
+BENCHMARK_DEFINE_F(SessionRows, lookup_withStatementStats)
+(benchmark::State &state) {
+  auto registry = Database::StatementStatsRegistry{};
+  Database::setStatementStatsRegistry(&registry);
+  {
+    auto query = Database::Query{lookupSql, m_conn};
+    auto id = 0;
+    for (auto _ : state) {
+      query.bind(id++ % 10000);
+      while (query.next()) {
+      }
+    }
+  }
+  Database::setStatementStatsRegistry(nullptr);
+}
+BENCHMARK_REGISTER_F(SessionRows, lookup_withStatementStats);
+
+// Cost of the latency histograms per execute(): state.range(0) turns
+// Metrics on.
+BENCHMARK_DEFINE_F(SessionRows, execute_metrics)(benchmark::State &state) {
+  Database::Metrics::setEnabled(state.range(0) != 0);
+  {
+    auto query = Database::Query{lookupSql, m_conn};
+    auto id = 0;
+    for (auto _ : state) {
+      query.bind(id++ % 10000);
+      query.execute();
+    }
+  }
+  Database::Metrics::setEnabled(false);
+  Database::Metrics::reset();
+}
+BENCHMARK_REGISTER_F(SessionRows, execute_metrics)->Arg(0)->Arg(1);
+
+// Same with a new (cached) Query per execute(), as request handlers do.
+BENCHMARK_DEFINE_F(SessionRows, query_metrics)(benchmark::State &state) {
+  Database::Metrics::setEnabled(state.range(0) != 0);
+  auto id = 0;
+  for (auto _ : state) {
+    auto query = Database::Query{lookupSql, m_conn};
+    query.bind(id++ % 10000);
+    query.execute();
+  }
+  Database::Metrics::setEnabled(false);
+  Database::Metrics::reset();
+}
+BENCHMARK_REGISTER_F(SessionRows, query_metrics)->Arg(0)->Arg(1);
+
+} // namespace
@@ -0,0 +1,252 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "database/ColumnBatch.h"
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/RowMapping.h"
+#include "database/StatementSpec.h"
+
+namespace {
+
+constexpr auto lookupSql =
+    R"sql(select id, payload from session where id = :id)sql";
+
+class SessionTable : public benchmark::Fixture {
+public:
+  void SetUp(const benchmark::State &) override {
+    Database::Query{
+        R"sql(create table if not exists session (id integer primary key, payload text))sql",
+        m_conn}
+        .execute();
+    Database::Query{R"sql(delete from session)sql", m_conn}.execute();
+
+    auto insert = Database::Query{
+        R"sql(insert into session values (:id, 'payload'))sql", m_conn};
+    for (auto i = 0; i < rowCount; ++i) {
+      insert.set("id", i);
+      insert.execute();
+    }
+  }
+
+protected:
+  static constexpr auto rowCount = 1000;
+  Database::Connection m_conn;
+};
+
+BENCHMARK_DEFINE_F(SessionTable, lookup_prepareEachTime)
+(benchmark::State &state) {
+  auto id = 0;
+  for (auto _ : state) {
+    auto query = Database::Query{lookupSql, m_conn};
+    query.set("id", id++ % rowCount);
+    query.execute();
+    benchmark::DoNotOptimize(query.get<int64_t>("id"));
+  }
+}
+BENCHMARK_REGISTER_F(SessionTable, lookup_prepareEachTime);
+
+BENCHMARK_DEFINE_F(SessionTable, lookup_reuseStatement)
+(benchmark::State &state) {
+  auto query = Database::Query{lookupSql, m_conn};
+  auto id = 0;
+  for (auto _ : state) {
+    query.set("id", id++ % rowCount);
+    query.execute();
+    benchmark::DoNotOptimize(query.get<int64_t>("id"));
+  }
+}
+BENCHMARK_REGISTER_F(SessionTable, lookup_reuseStatement);
+
+struct SessionRow {
+  std::int64_t id = 0;
+  std::string payload;
+};
+
+// Allocator-aware, so a std::pmr::vector hands its resource to each row.
+struct PmrSessionRow {
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  explicit PmrSessionRow(const allocator_type &allocator = {})
+      : payload(allocator) {}
+  PmrSessionRow(PmrSessionRow &&other, const allocator_type &allocator)
+      : id(other.id), payload(std::move(other.payload), allocator) {}
+
+  std::int64_t id = 0;
+  std::pmr::string payload;
+};
+
+} // namespace
+
+template <> struct Database::RowMapping<SessionRow> {
+  static constexpr auto fields =
+      std::tuple{Database::field("id", &SessionRow::id),
+                 Database::field("payload", &SessionRow::payload)};
+};
+
+template <> struct Database::RowMapping<PmrSessionRow> {
+  static constexpr auto fields =
+      std::tuple{Database::field("id", &PmrSessionRow::id),
+                 Database::field("payload", &PmrSessionRow::payload)};
+};
+
+namespace {
+
+constexpr auto scanSql = R"sql(select id, payload from session)sql";
+
+BENCHMARK_DEFINE_F(SessionTable, scan_getByName)(benchmark::State &state) {
+  auto query = Database::Query{scanSql, m_conn};
+  for (auto _ : state) {
+    auto row = SessionRow{};
+    while (query.next()) {
+      row.id = query.get<std::int64_t>("id");
+      row.payload = query.get<std::string>("payload");
+      benchmark::DoNotOptimize(row);
+    }
+    query.reset();
+  }
+}
+BENCHMARK_REGISTER_F(SessionTable, scan_getByName);
+
+BENCHMARK_DEFINE_F(SessionTable, scan_rowsAs)(benchmark::State &state) {
+  auto query = Database::Query{scanSql, m_conn};
+  for (auto _ : state) {
+    for (const auto &row : query.rowsAs<SessionRow>())
+      benchmark::DoNotOptimize(row);
+    query.reset();
+  }
+}
+BENCHMARK_REGISTER_F(SessionTable, scan_rowsAs);
+
+BENCHMARK_DEFINE_F(SessionTable, scan_fetchColumns)(benchmark::State &state) {
+  auto query = Database::Query{scanSql, m_conn};
+  auto batch = Database::ColumnBatch<std::int64_t, std::string>{};
+  for (auto _ : state) {
+    while (query.fetchColumns(batch, 256))
+      benchmark::DoNotOptimize(batch.column<0>().data());
+    query.reset();
+  }
+}
+BENCHMARK_REGISTER_F(SessionTable, scan_fetchColumns);
+
+// Whole result read at once, with payloads too long for the small string
+// optimization: one heap allocation per row and string, versus a
+// monotonic arena released in one go.
+constexpr auto batchSql =
+    R"sql(select id, payload || payload || payload || payload || payload || payload as payload
+          from session)sql";
+
+BENCHMARK_DEFINE_F(SessionTable, batch_vector)(benchmark::State &state) {
+  auto query = Database::Query{batchSql, m_conn};
+  for (auto _ : state) {
+    auto rows = std::vector<SessionRow>{};
+    query.fetchAllInto(rows);
+    benchmark::DoNotOptimize(rows.data());
+    query.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * rowCount);
+}
+BENCHMARK_REGISTER_F(SessionTable, batch_vector);
+
+BENCHMARK_DEFINE_F(SessionTable, batch_pmrArena)(benchmark::State &state) {
+  auto query = Database::Query{batchSql, m_conn};
+  auto buffer = std::vector<std::byte>(256 * 1024);
+  for (auto _ : state) {
+    auto arena =
+        std::pmr::monotonic_buffer_resource{buffer.data(), buffer.size()};
+    auto rows = std::pmr::vector<PmrSessionRow>{&arena};
+    query.fetchAllInto(rows);
+    benchmark::DoNotOptimize(rows.data());
+    query.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * rowCount);
+}
+BENCHMARK_REGISTER_F(SessionTable, batch_pmrArena);
+
+constexpr auto wideRowSql =
+    R"sql(select 1 c01, 2 c02, 3 c03, 4 c04, 5 c05, 6 c06, 7 c07, 8 c08,
+                 9 c09, 10 c10, 11 c11, 12 c12, 13 c13, 14 c14, 15 c15, 16 c16)sql";
+
+static void get_byName(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{wideRowSql, conn};
+  query.execute();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(query.get<int64_t>("c16"));
+}
+BENCHMARK(get_byName);
+
+static void get_byColumnHandle(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{wideRowSql, conn};
+  query.execute();
+  const auto column = query.column("c16");
+  for (auto _ : state)
+    benchmark::DoNotOptimize(query.get<int64_t>(column));
+}
+BENCHMARK(get_byColumnHandle);
+
+constexpr auto bindSpec =
+    Database::StatementSpec{R"sql(select :value 'value')sql",
+                            Database::names("value"), Database::names("value")};
+
+static void set_byName(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{bindSpec, conn};
+  for (auto _ : state)
+    query.set("value", 1);
+}
+BENCHMARK(set_byName);
+
+static void set_byParameterHandle(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{bindSpec, conn};
+  constexpr auto value = bindSpec.parameter("value");
+  for (auto _ : state)
+    query.set(value, 1);
+}
+BENCHMARK(set_byParameterHandle);
+
+constexpr auto payloadSql = R"sql(select randomblob(4096) 'payload')sql";
+
+static void get_blobCopy(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{payloadSql, conn};
+  query.execute();
+  const auto column = query.column("payload");
+  for (auto _ : state)
+    benchmark::DoNotOptimize(query.get<std::vector<std::byte>>(column));
+}
+BENCHMARK(get_blobCopy);
+
+static void get_blobSpan(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{payloadSql, conn};
+  query.execute();
+  const auto column = query.column("payload");
+  for (auto _ : state)
+    benchmark::DoNotOptimize(query.get<Database::ByteSpan>(column));
+}
+BENCHMARK(get_blobSpan);
+
+static void get_blobInto(benchmark::State &state) {
+  auto conn = Database::Connection{};
+  auto query = Database::Query{payloadSql, conn};
+  query.execute();
+  const auto column = query.column("payload");
+  auto buffer = std::vector<std::byte>{};
+  for (auto _ : state) {
+    query.getInto(column, buffer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+BENCHMARK(get_blobInto);
+
+} // namespace
@@ -0,0 +1,138 @@
+#include "AsyncDatabase.h"
+
+namespace Database::coro {
+
+auto RowStream::State::startFill() -> bool {
+  if (filling || done || cancelled)
+    return false;
+  filling = true;
+  return true;
+}
+
+auto RowStream::State::postFill() -> void {
+  executor.post([self = shared_from_this()] { self->fill(); });
+}
+
+auto RowStream::State::fill() -> void {
+  auto failure = std::exception_ptr{};
+  try {
+    if (!query) {
+      lease.emplace(executor.acquire(Access::Read));
+      query = std::exchange(prepare, nullptr)(**lease);
+    }
+
+    const auto columns = query->columnCount();
+    while (true) {
+      {
+        // Stopping and clearing the flag happen together, so a consumer
+        // that drains the buffer afterwards starts the next fill.
+        const auto lock = std::lock_guard{mutex};
+        if (cancelled || rows.size() >= capacity) {
+          filling = false;
+          if (cancelled)
+            close();
+          return;
+        }
+      }
+      if (!query->next())
+        break;
+
+      auto row = Row{};
+      row.reserve(columns);
+      for (auto column = 0; column < columns; ++column)
+        row.push_back(query->get<Value>(Column{column}));
+
+      auto awaiting = std::coroutine_handle<>{};
+      {
+        const auto lock = std::lock_guard{mutex};
+        rows.push_back(std::move(row));
+        awaiting = std::exchange(waiting, {});
+      }
+      if (awaiting)
+        resume(awaiting);
+    }
+  } catch (...) {
+    failure = std::current_exception();
+  }
+  finish(std::move(failure));
+}
+
+auto RowStream::State::finish(std::exception_ptr failure) -> void {
+  auto awaiting = std::coroutine_handle<>{};
+  {
+    const auto lock = std::lock_guard{mutex};
+    filling = false;
+    done = true;
+    error = std::move(failure);
+    awaiting = std::exchange(waiting, {});
+    // The reader goes back to the pool as soon as the result is exhausted.
+    close();
+  }
+  if (awaiting)
+    resume(awaiting);
+}
+
+auto RowStream::State::resume(std::coroutine_handle<> awaiting) -> void {
+  executor.post([awaiting] { awaiting.resume(); });
+}
+
+auto RowStream::State::close() -> void {
+  // The statement belongs to the leased connection.
+  query.reset();
+  lease.reset();
+  prepare = nullptr;
+}
+
+RowStream::RowStream(std::shared_ptr<State> state)
+    : m_state(std::move(state)) {}
+
+RowStream::~RowStream() {
+  if (!m_state)
+    return;
+
+  // A running fill closes the stream itself once it sees the flag.
+  const auto lock = std::lock_guard{m_state->mutex};
+  m_state->cancelled = true;
+  m_state->waiting = {};
+  if (!m_state->filling)
+    m_state->close();
+}
+
+auto RowStream::next() -> NextAwaiter { return NextAwaiter{*m_state}; }
+
+auto RowStream::NextAwaiter::await_suspend(std::coroutine_handle<> awaiting)
+    -> bool {
+  {
+    const auto lock = std::lock_guard{m_state.mutex};
+    if (!m_state.rows.empty() || m_state.done)
+      return false;
+    m_state.waiting = awaiting;
+    if (!m_state.startFill())
+      return true;
+  }
+  // Nothing resumes the consumer before this fill runs, so the state is
+  // still alive here.
+  m_state.postFill();
+  return true;
+}
+
+auto RowStream::NextAwaiter::await_resume() -> std::optional<Row> {
+  auto lock = std::unique_lock{m_state.mutex};
+  if (m_state.rows.empty()) {
+    if (m_state.error)
+      std::rethrow_exception(m_state.error);
+    return std::nullopt;
+  }
+
+  auto row = std::move(m_state.rows.front());
+  m_state.rows.pop_front();
+  // Refilled in batches rather than a row at a time.
+  const auto refill =
+      m_state.rows.size() <= m_state.capacity / 2 && m_state.startFill();
+  lock.unlock();
+  if (refill)
+    m_state.postFill();
+  return row;
+}
+
+} // namespace Database::coro
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "database/AsyncExecutor.h"
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/Value.h"
+#include "database/coro/database_coro_export.h"
+
+namespace Database::coro {
+
+// Column values of one result row, in select order.
+using Row = std::vector<Value>;
+
+namespace detail {
+
+template <typename... ArgsT>
+auto bindAll(Query &query, std::tuple<ArgsT...> &arguments) -> void {
+  std::apply([&query](auto &...argument) { query.bind(argument...); },
+             arguments);
+}
+
+// Resumes the awaiting coroutine on the executor worker that ran the work.
+// The work is posted rather than submitted: awaits are mostly made from
+// workers, which must not block on a queue only workers drain.
+template <typename WorkT> class ExecutorAwaiter {
+public:
+  using ResultT = AsyncExecutor::ResultOf<WorkT>;
+
+  ExecutorAwaiter(AsyncExecutor &executor, Access access, WorkT work)
+      : m_executor(executor), m_access(access), m_work(std::move(work)) {}
+
+  auto await_ready() const noexcept -> bool { return false; }
+
+  auto await_suspend(std::coroutine_handle<> awaiting) -> void {
+    m_executor.post([this, awaiting] {
+      auto task = std::packaged_task<ResultT()>{[this] {
+        auto lease = m_executor.acquire(m_access);
+        return m_work(*lease);
+      }};
+      m_result = task.get_future();
+      task();
+      awaiting.resume();
+    });
+  }
+
+  auto await_resume() -> ResultT { return m_result.get(); }
+
+private:
+  AsyncExecutor &m_executor;
+  Access m_access;
+  WorkT m_work;
+  std::future<ResultT> m_result;
+};
+
+} // namespace detail
+
+// Rows of a select, produced on executor workers while the consumer awaits
+// them:
+//
+//   auto rows = db.rows(sql, id);
+//   while (auto row = co_await rows.next())
+//     ...
+//
+// The stream holds a reader lease until the result is exhausted or the
+// stream destroyed. Rows are produced in executor tasks that stop once
+// `capacity` rows are buffered ahead of the consumer, so a stream only
+// occupies a worker while it fills its buffer. The consumer is resumed
+// through the executor as well.
+class DATABASE_CORO_EXPORT RowStream {
+public:
+  class NextAwaiter;
+
+  RowStream(RowStream &&) noexcept = default;
+  auto operator=(RowStream &&) noexcept -> RowStream & = default;
+  virtual ~RowStream();
+
+  // Yields std::nullopt after the last row; rethrows the query's error.
+  auto next() -> NextAwaiter;
+
+private:
+  friend class AsyncDatabase;
+
+  using Prepare = std::function<std::unique_ptr<Query>(Connection &)>;
+
+  struct State : std::enable_shared_from_this<State> {
+    State(AsyncExecutor &executor, std::size_t capacity, Prepare prepare)
+        : executor(executor), capacity(std::max<std::size_t>(capacity, 1)),
+          prepare(std::move(prepare)) {}
+
+    AsyncExecutor &executor;
+    const std::size_t capacity;
+
+    std::mutex mutex;
+    std::deque<Row> rows;
+    std::coroutine_handle<> waiting;
+    std::exception_ptr error;
+    bool done = false;
+    bool cancelled = false;
+    // Set while a fill is queued or running. The fill alone touches the
+    // members below; otherwise they are guarded by the mutex.
+    bool filling = false;
+
+    Prepare prepare;
+    std::optional<ConnectionPool::Lease> lease;
+    std::unique_ptr<Query> query;
+
+    // With the mutex held: marks a fill as pending unless one is or the
+    // stream ended. The caller queues it with postFill() after unlocking.
+    auto startFill() -> bool;
+    auto postFill() -> void;
+    // Runs on a worker: steps the query until the buffer is full.
+    auto fill() -> void;
+    auto finish(std::exception_ptr failure) -> void;
+    auto resume(std::coroutine_handle<> awaiting) -> void;
+    auto close() -> void;
+  };
+
+  explicit RowStream(std::shared_ptr<State> state);
+
+  std::shared_ptr<State> m_state;
+};
+
+class DATABASE_CORO_EXPORT RowStream::NextAwaiter {
+public:
+  explicit NextAwaiter(State &state) : m_state(state) {}
+
+  auto await_ready() const noexcept -> bool { return false; }
+  auto await_suspend(std::coroutine_handle<> awaiting) -> bool;
+  auto await_resume() -> std::optional<Row>;
+
+private:
+  State &m_state;
+};
+
+// Awaitable front end of an AsyncExecutor. Arguments bind positionally to
+// the statement's parameters, through Query::set. Awaiting coroutines are
+// resumed on executor worker threads. Awaited work never blocks on, nor is
+// bounded by, the executor's queue capacity.
+class DATABASE_CORO_EXPORT AsyncDatabase {
+public:
+  explicit AsyncDatabase(AsyncExecutor &executor) : m_executor(executor) {}
+
+  // Runs any Connection& callable, as AsyncExecutor::submit does.
+  template <typename WorkT> auto run(Access access, WorkT &&work) {
+    return detail::ExecutorAwaiter<std::decay_t<WorkT>>{
+        m_executor, access, std::forward<WorkT>(work)};
+  }
+
+  // Runs a statement on the writer; yields the number of changed rows.
+  template <typename... ArgsT>
+  auto execute(std::string sql, ArgsT &&...args) {
+    return run(Access::Write,
+               [sql = std::move(sql),
+                arguments = std::make_tuple(std::forward<ArgsT>(args)...)](
+                   Connection &connection) mutable -> std::int64_t {
+                 auto query = Query{sql, connection};
+                 detail::bindAll(query, arguments);
+                 while (query.next()) {
+                 }
+                 return connection.changes();
+               });
+  }
+
+  // Streams the rows of a select run on a reader. The first rows are
+  // fetched right away.
+  template <typename... ArgsT>
+  auto rows(std::string sql, ArgsT &&...args) -> RowStream {
+    auto state = std::make_shared<RowStream::State>(
+        m_executor, m_rowBufferCapacity,
+        [sql = std::move(sql),
+         arguments = std::make_tuple(std::forward<ArgsT>(args)...)](
+            Connection &connection) mutable {
+          auto query = std::make_unique<Query>(sql, connection);
+          detail::bindAll(*query, arguments);
+          return query;
+        });
+    // Not shared yet, so set without the lock.
+    state->filling = true;
+    state->postFill();
+    return RowStream{std::move(state)};
+  }
+
+  // Rows a stream buffers ahead of its consumer.
+  auto setRowBufferCapacity(std::size_t capacity) -> void {
+    m_rowBufferCapacity = capacity;
+  }
+
+private:
+  AsyncExecutor &m_executor;
+  std::size_t m_rowBufferCapacity = 256;
+};
+
+} // namespace Database::coro
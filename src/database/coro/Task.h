@@ -0,0 +1,167 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace Database::coro {
+
+template <typename ValueT = void> class Task;
+
+namespace detail {
+
+class PromiseBase {
+public:
+  struct FinalAwaiter {
+    auto await_ready() const noexcept -> bool { return false; }
+
+    template <typename PromiseT>
+    auto await_suspend(std::coroutine_handle<PromiseT> handle) noexcept
+        -> std::coroutine_handle<> {
+      if (const auto continuation = handle.promise().m_continuation)
+        return continuation;
+      return std::noop_coroutine();
+    }
+
+    auto await_resume() noexcept -> void {}
+  };
+
+  auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+  auto final_suspend() noexcept -> FinalAwaiter { return {}; }
+  auto unhandled_exception() -> void { m_error = std::current_exception(); }
+
+  auto setContinuation(std::coroutine_handle<> continuation) -> void {
+    m_continuation = continuation;
+  }
+
+protected:
+  auto rethrowIfFailed() -> void {
+    if (m_error)
+      std::rethrow_exception(m_error);
+  }
+
+private:
+  std::coroutine_handle<> m_continuation;
+  std::exception_ptr m_error;
+};
+
+template <typename ValueT> class Promise : public PromiseBase {
+public:
+  auto get_return_object() -> Task<ValueT>;
+
+  template <typename FromT> auto return_value(FromT &&value) -> void {
+    m_value.emplace(std::forward<FromT>(value));
+  }
+
+  auto result() -> ValueT {
+    rethrowIfFailed();
+    return std::move(*m_value);
+  }
+
+private:
+  std::optional<ValueT> m_value;
+};
+
+template <> class Promise<void> : public PromiseBase {
+public:
+  auto get_return_object() -> Task<void>;
+  auto return_void() -> void {}
+  auto result() -> void { rethrowIfFailed(); }
+};
+
+// Starts eagerly and frees itself when done; only used to bridge into
+// blocking code.
+struct Detached {
+  struct promise_type {
+    auto get_return_object() -> Detached { return {}; }
+    auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+    auto final_suspend() noexcept -> std::suspend_never { return {}; }
+    auto return_void() -> void {}
+    auto unhandled_exception() -> void { std::terminate(); }
+  };
+};
+
+} // namespace detail
+
+// Lazily started coroutine returning ValueT. Awaiting it starts it; the
+// awaiting coroutine is resumed on whichever thread the task completes.
+template <typename ValueT> class [[nodiscard]] Task {
+public:
+  using promise_type = detail::Promise<ValueT>;
+
+  explicit Task(std::coroutine_handle<promise_type> handle)
+      : m_handle(handle) {}
+  Task(Task &&other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+  auto operator=(Task &&other) noexcept -> Task & {
+    if (this != &other) {
+      if (m_handle)
+        m_handle.destroy();
+      m_handle = std::exchange(other.m_handle, {});
+    }
+    return *this;
+  }
+  ~Task() {
+    if (m_handle)
+      m_handle.destroy();
+  }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      auto await_ready() const noexcept -> bool { return false; }
+      auto await_suspend(std::coroutine_handle<> awaiting) noexcept
+          -> std::coroutine_handle<> {
+        handle.promise().setContinuation(awaiting);
+        return handle;
+      }
+      auto await_resume() -> ValueT { return handle.promise().result(); }
+    };
+    return Awaiter{m_handle};
+  }
+
+private:
+  std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail {
+
+template <typename ValueT>
+inline auto Promise<ValueT>::get_return_object() -> Task<ValueT> {
+  return Task<ValueT>{
+      std::coroutine_handle<Promise<ValueT>>::from_promise(*this)};
+}
+
+inline auto Promise<void>::get_return_object() -> Task<void> {
+  return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)};
+}
+
+} // namespace detail
+
+// Runs a task to completion, blocking the calling thread. For tests and for
+// entry points outside of any coroutine.
+template <typename ValueT> auto syncWait(Task<ValueT> task) -> ValueT {
+  auto result = std::promise<ValueT>{};
+  auto future = result.get_future();
+
+  // The promise lives in the coroutine frame, so setting it cannot race with
+  // this function returning.
+  [](Task<ValueT> task, std::promise<ValueT> result) -> detail::Detached {
+    try {
+      if constexpr (std::is_void_v<ValueT>) {
+        co_await std::move(task);
+        result.set_value();
+      } else
+        result.set_value(co_await std::move(task));
+    } catch (...) {
+      result.set_exception(std::current_exception());
+    }
+  }(std::move(task), std::move(result));
+
+  return future.get();
+}
+
+} // namespace Database::coro
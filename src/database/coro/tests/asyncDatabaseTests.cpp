@@ -0,0 +1,196 @@
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "database/Exceptions.h"
+#include "database/coro/AsyncDatabase.h"
+#include "database/coro/Task.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Database::Access;
+using Database::Connection;
+using Database::Value;
+using Database::coro::AsyncDatabase;
+using Database::coro::syncWait;
+using Database::coro::Task;
+
+constexpr auto databaseFile = "asyncDatabase.db3";
+
+auto removeDatabase() -> void {
+  for (const auto suffix : {"", "-wal", "-shm"})
+    std::filesystem::remove(std::string{databaseFile} + suffix);
+}
+
+class AsyncDatabaseTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    removeDatabase();
+    auto options = Database::ConnectionPoolOptions{};
+    options.readers = 2;
+    m_pool = std::make_unique<Database::ConnectionPool>(databaseFile, options);
+    m_executor = std::make_unique<Database::AsyncExecutor>(*m_pool);
+    m_db = std::make_unique<AsyncDatabase>(*m_executor);
+
+    syncWait(createTable());
+  }
+
+  void TearDown() override {
+    m_db.reset();
+    m_executor.reset();
+    m_pool.reset();
+    removeDatabase();
+  }
+
+  auto createTable() -> Task<> {
+    co_await m_db->execute(
+        R"sql(create table session (id integer primary key, user text))sql");
+  }
+
+  auto insertSessions(int count) -> Task<std::int64_t> {
+    auto inserted = std::int64_t{0};
+    for (auto i = 0; i < count; ++i)
+      inserted += co_await m_db->execute(
+          R"sql(insert into session values (?, ?))sql", i, "user");
+    co_return inserted;
+  }
+
+  std::unique_ptr<Database::ConnectionPool> m_pool;
+  std::unique_ptr<Database::AsyncExecutor> m_executor;
+  std::unique_ptr<AsyncDatabase> m_db;
+};
+
+TEST_F(AsyncDatabaseTest, executeYieldsChangedRows) {
+  EXPECT_THAT(syncWait(insertSessions(10)), ::testing::Eq(10));
+}
+
+TEST_F(AsyncDatabaseTest, executeResumesOnWorkerThread) {
+  const auto caller = std::this_thread::get_id();
+
+  const auto resumedOn = syncWait([this]() -> Task<std::thread::id> {
+    co_await m_db->execute(R"sql(insert into session values (1, 'a'))sql");
+    co_return std::this_thread::get_id();
+  }());
+
+  EXPECT_THAT(resumedOn, ::testing::Ne(caller));
+}
+
+TEST_F(AsyncDatabaseTest, runAwaitsAnyConnectionWork) {
+  syncWait(insertSessions(3));
+
+  const auto count = syncWait([this]() -> Task<std::int64_t> {
+    co_return co_await m_db->run(Access::Read, [](Connection &conn) {
+      auto query = Database::Query{
+          R"sql(select count(1) 'c' from session)sql", conn};
+      query.execute();
+      return query.get<std::int64_t>("c");
+    });
+  }());
+
+  EXPECT_THAT(count, ::testing::Eq(3));
+}
+
+TEST_F(AsyncDatabaseTest, rowStreamYieldsAllRows) {
+  syncWait(insertSessions(1000));
+  m_db->setRowBufferCapacity(16);
+
+  const auto ids = syncWait([this]() -> Task<std::vector<std::int64_t>> {
+    auto ids = std::vector<std::int64_t>{};
+    auto rows = m_db->rows(
+        R"sql(select id, user from session where id >= ? order by id)sql", 0);
+    while (auto row = co_await rows.next())
+      ids.push_back(std::get<std::int64_t>(row->at(0)));
+    co_return ids;
+  }());
+
+  ASSERT_THAT(ids.size(), ::testing::Eq(1000u));
+  EXPECT_THAT(ids.front(), ::testing::Eq(0));
+  EXPECT_THAT(ids.back(), ::testing::Eq(999));
+}
+
+TEST_F(AsyncDatabaseTest, interleavedRowStreamsShareOneWorker) {
+  syncWait(insertSessions(100));
+  auto options = Database::AsyncExecutorOptions{};
+  options.workers = 1;
+  auto executor = Database::AsyncExecutor{*m_pool, options};
+  auto db = AsyncDatabase{executor};
+  db.setRowBufferCapacity(4);
+
+  const auto sum = syncWait([&db]() -> Task<std::int64_t> {
+    constexpr auto sql = R"sql(select id from session order by id)sql";
+    auto first = db.rows(sql);
+    auto second = db.rows(sql);
+    auto sum = std::int64_t{0};
+    while (true) {
+      const auto a = co_await first.next();
+      const auto b = co_await second.next();
+      if (!a || !b)
+        co_return a || b ? -1 : sum;
+      sum += std::get<std::int64_t>(a->at(0)) +
+             std::get<std::int64_t>(b->at(0));
+    }
+  }());
+
+  EXPECT_THAT(sum, ::testing::Eq(2 * 4950));
+}
+
+TEST_F(AsyncDatabaseTest, awaitsFromWorkersDoNotBlockOnFullQueue) {
+  constexpr auto callers = 4;
+  constexpr auto insertsPerCaller = 50;
+  auto options = Database::AsyncExecutorOptions{};
+  options.workers = 1;
+  options.queueCapacity = 1;
+  auto executor = Database::AsyncExecutor{*m_pool, options};
+  auto db = AsyncDatabase{executor};
+
+  // Every await after the first is made from the single worker.
+  const auto insert = [](AsyncDatabase &db, int first) -> Task<std::int64_t> {
+    auto inserted = std::int64_t{0};
+    for (auto id = first; id < first + insertsPerCaller; ++id)
+      inserted += co_await db.execute(
+          R"sql(insert into session values (?, ?))sql", id, "user");
+    co_return inserted;
+  };
+  auto inserted = std::vector<std::int64_t>(callers);
+  auto threads = std::vector<std::thread>{};
+  for (auto c = 0; c < callers; ++c)
+    threads.emplace_back([&, c] {
+      inserted[c] = syncWait(insert(db, c * insertsPerCaller));
+    });
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_THAT(inserted, ::testing::Each(::testing::Eq(insertsPerCaller)));
+}
+
+TEST_F(AsyncDatabaseTest, abandonedRowStreamReleasesItsReader) {
+  syncWait(insertSessions(100));
+  m_db->setRowBufferCapacity(1);
+
+  const auto first = syncWait([this]() -> Task<Value> {
+    auto rows = m_db->rows(R"sql(select user from session)sql");
+    co_return (co_await rows.next())->front();
+  }());
+
+  EXPECT_THAT(first, ::testing::Eq(Value{"user"}));
+  // Both readers must be free again.
+  auto a = m_pool->acquireReader(std::chrono::seconds{1});
+  auto b = m_pool->acquireReader(std::chrono::seconds{1});
+}
+
+TEST_F(AsyncDatabaseTest, rowStreamRethrowsQueryError) {
+  const auto consume = [this]() -> Task<> {
+    auto rows = m_db->rows(R"sql(select * from missing)sql");
+    while (co_await rows.next()) {
+    }
+  };
+
+  EXPECT_THROW(syncWait(consume()), Database::QueryError);
+}
+
+} // namespace
@@ -11,7 +11,7 @@ bool isTableExist(Connection &conn, std::string_view tableName) {
   auto q = Query(
       R"sql(select count(1) 'c' from sqlite_master where type='table' and name=:tableName)sql",
       conn);
-  q.set<std::string>("tableName", tableName.data());
+  q.set("tableName", tableName, BindLifetime::Static);
   q.execute();
 
   return q.get<std::int64_t>("c") > 0;
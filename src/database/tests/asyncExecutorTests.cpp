@@ -0,0 +1,149 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "database/AsyncExecutor.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+using Database::Access;
+using Database::Connection;
+using Q = Database::Query;
+
+constexpr auto databaseFile = "asyncExecutor.db3";
+
+auto removeDatabase() -> void {
+  for (const auto suffix : {"", "-wal", "-shm"})
+    std::filesystem::remove(std::string{databaseFile} + suffix);
+}
+
+auto countRows(Connection &conn) -> std::int64_t {
+  auto query = Q{R"sql(select count(1) 'c' from session)sql", conn};
+  query.execute();
+  return query.get<std::int64_t>("c");
+}
+
+class AsyncExecutorTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    removeDatabase();
+    auto options = Database::ConnectionPoolOptions{};
+    options.readers = 2;
+    m_pool = std::make_unique<Database::ConnectionPool>(databaseFile, options);
+
+    auto writer = m_pool->acquireWriter();
+    Q{R"sql(create table session (id integer primary key))sql", *writer}
+        .execute();
+  }
+
+  void TearDown() override {
+    m_pool.reset();
+    removeDatabase();
+  }
+
+  std::unique_ptr<Database::ConnectionPool> m_pool;
+};
+
+TEST_F(AsyncExecutorTest, writesThenReadsThroughFutures) {
+  auto executor = Database::AsyncExecutor{*m_pool};
+
+  auto writes = std::vector<std::future<void>>{};
+  for (auto i = 0; i < 100; ++i)
+    writes.push_back(executor.submit(Access::Write, [i](Connection &conn) {
+      auto insert = Q{R"sql(insert into session values (:id))sql", conn};
+      insert.set("id", i);
+      insert.execute();
+    }));
+  for (auto &write : writes)
+    write.get();
+
+  auto count = executor.submit(Access::Read, countRows);
+
+  EXPECT_THAT(count.get(), ::testing::Eq(100));
+}
+
+TEST_F(AsyncExecutorTest, readTasksRunOnReadOnlyConnections) {
+  auto executor = Database::AsyncExecutor{*m_pool};
+
+  auto result = executor.submit(Access::Read, [](Connection &conn) {
+    Q{R"sql(insert into session values (1))sql", conn}.execute();
+  });
+
+  EXPECT_THROW(result.get(), Database::QueryError);
+}
+
+TEST_F(AsyncExecutorTest, callbackReceivesReadyFuture) {
+  auto executor = Database::AsyncExecutor{*m_pool};
+  auto delivered = std::promise<std::int64_t>{};
+
+  executor.submit(Access::Read, countRows,
+                  [&delivered](std::future<std::int64_t> result) {
+                    delivered.set_value(result.get());
+                  });
+
+  EXPECT_THAT(delivered.get_future().get(), ::testing::Eq(0));
+}
+
+TEST_F(AsyncExecutorTest, throwingCallbackDoesNotStopWorker) {
+  auto options = Database::AsyncExecutorOptions{};
+  options.workers = 1;
+  auto executor = Database::AsyncExecutor{*m_pool, options};
+
+  executor.submit(Access::Read, countRows, [](std::future<std::int64_t>) {
+    throw std::runtime_error{"callback failed"};
+  });
+  auto count = executor.submit(Access::Read, countRows);
+
+  EXPECT_THAT(count.get(), ::testing::Eq(0));
+}
+
+TEST_F(AsyncExecutorTest, trySubmitReportsFullQueue) {
+  auto options = Database::AsyncExecutorOptions{};
+  options.workers = 1;
+  options.queueCapacity = 1;
+  auto executor = Database::AsyncExecutor{*m_pool, options};
+
+  auto started = std::promise<void>{};
+  auto unblock = std::promise<void>{};
+  auto unblocked = unblock.get_future().share();
+  auto busy = executor.submit(Access::Read, [&](Connection &) {
+    started.set_value();
+    unblocked.wait();
+  });
+  started.get_future().wait();
+
+  auto queued = executor.trySubmit(Access::Read, countRows);
+  auto rejected = executor.trySubmit(Access::Read, countRows);
+
+  EXPECT_TRUE(queued.has_value());
+  EXPECT_FALSE(rejected.has_value());
+
+  unblock.set_value();
+  busy.get();
+  EXPECT_THAT(queued->get(), ::testing::Eq(0));
+}
+
+TEST_F(AsyncExecutorTest, destructorRunsQueuedTasks) {
+  auto ran = std::atomic<int>{0};
+  {
+    auto options = Database::AsyncExecutorOptions{};
+    options.workers = 2;
+    auto executor = Database::AsyncExecutor{*m_pool, options};
+    for (auto i = 0; i < 50; ++i)
+      executor.submit(Access::Read, [&ran](Connection &) { ++ran; });
+  }
+
+  EXPECT_THAT(ran.load(), ::testing::Eq(50));
+}
+
+} // namespace
@@ -0,0 +1,82 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "database/Connection.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+
+class BindFetchTest : public ::testing::Test {
+protected:
+  Database::Connection m_conn;
+};
+
+TEST_F(BindFetchTest, bindAndFetchRoundTrip) {
+  auto query = Q{R"sql(select ?, ?, ?, ?, ?)sql", m_conn};
+  query.bind(std::int64_t{1} << 40, std::string{"text"}, 2.5,
+             std::optional<int>{}, std::vector{std::byte{9}});
+  query.execute();
+
+  const auto [id, text, score, missing, blob] =
+      query.fetch<std::int64_t, std::string, double, std::optional<int>,
+                  std::vector<std::byte>>();
+
+  EXPECT_THAT(id, ::testing::Eq(std::int64_t{1} << 40));
+  EXPECT_THAT(text, ::testing::Eq("text"));
+  EXPECT_THAT(score, ::testing::Eq(2.5));
+  EXPECT_THAT(missing, ::testing::Eq(std::nullopt));
+  EXPECT_THAT(blob, ::testing::ElementsAre(std::byte{9}));
+}
+
+TEST_F(BindFetchTest, bindsNamedParametersByPosition) {
+  auto query = Q{R"sql(select :b - :a 'diff')sql", m_conn};
+  // Named parameters are numbered in order of first appearance.
+  query.bind(10, 3);
+  query.execute();
+
+  EXPECT_THAT(std::get<0>(query.fetch<int>()), ::testing::Eq(7));
+}
+
+TEST_F(BindFetchTest, rebindRerunsStatement) {
+  auto query = Q{R"sql(select ? * 2)sql", m_conn};
+
+  auto results = std::vector<int>{};
+  for (auto value : {1, 2, 3}) {
+    query.bind(value);
+    query.execute();
+    results.push_back(std::get<0>(query.fetch<int>()));
+  }
+
+  EXPECT_THAT(results, ::testing::ElementsAre(2, 4, 6));
+}
+
+TEST_F(BindFetchTest, fetchOverRows) {
+  auto query = Q{
+      R"sql(select column1, column2 from (values (1, 'a'), (2, null)))sql",
+      m_conn};
+
+  auto rows = std::vector<std::tuple<int, std::optional<std::string>>>{};
+  while (query.next())
+    rows.push_back(query.fetch<int, std::optional<std::string>>());
+
+  EXPECT_THAT(rows, ::testing::ElementsAre(std::tuple{1, "a"},
+                                           std::tuple{2, std::nullopt}));
+}
+
+TEST_F(BindFetchTest, expectThrowWhenTooManyValues) {
+  auto query = Q{R"sql(select ?)sql", m_conn};
+
+  EXPECT_THROW(query.bind(1, 2), Database::QueryError);
+}
+
+} // namespace
@@ -0,0 +1,135 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "database/Connection.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+using Database::BindLifetime;
+
+int freedBlobs = 0;
+
+auto freeBlob(void *data) -> void {
+  std::free(data);
+  ++freedBlobs;
+}
+
+auto makeOwnedBlob(std::string_view content) -> Database::OwnedBlob {
+  const auto data = std::malloc(content.size());
+  std::memcpy(data, content.data(), content.size());
+  return {data, content.size(), freeBlob};
+}
+
+class BindLifetimeTest : public ::testing::Test {
+protected:
+  void SetUp() override { freedBlobs = 0; }
+
+  Database::Connection m_conn;
+};
+
+TEST_F(BindLifetimeTest, transientCopiesValue) {
+  auto value = std::string{"before"};
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", value);
+  value = "after";
+  query.execute();
+
+  EXPECT_THAT(query.get<std::string>("value"), ::testing::Eq("before"));
+}
+
+TEST_F(BindLifetimeTest, staticReadsCallerBufferAtExecute) {
+  auto value = std::string{"before"};
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", std::string_view{value}, BindLifetime::Static);
+  value.replace(0, 6, "after!");
+  query.execute();
+
+  EXPECT_THAT(query.get<std::string>("value"), ::testing::Eq("after!"));
+}
+
+TEST_F(BindLifetimeTest, staticBlob) {
+  const auto value = std::vector<std::byte>(4096, std::byte{0x2a});
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", value, BindLifetime::Static);
+  query.execute();
+
+  EXPECT_THAT(query.get<std::vector<std::byte>>("value"),
+              ::testing::Eq(value));
+}
+
+TEST_F(BindLifetimeTest, movedStringOutlivesSource) {
+  auto query = Q{R"sql(select :short 'short', :long 'long')sql", m_conn};
+  const auto longValue = std::string(4096, 'x');
+  {
+    auto shortSource = std::string{"sso"};
+    auto longSource = longValue;
+    query.set("short", std::move(shortSource));
+    query.set("long", std::move(longSource));
+  }
+  query.execute();
+
+  EXPECT_THAT(query.get<std::string>("short"), ::testing::Eq("sso"));
+  EXPECT_THAT(query.get<std::string>("long"), ::testing::Eq(longValue));
+}
+
+TEST_F(BindLifetimeTest, movedBlobCanBeRebound) {
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", std::vector<std::byte>(8, std::byte{1}));
+  query.execute();
+  query.set("val", std::vector<std::byte>(16, std::byte{2}));
+  query.execute();
+
+  EXPECT_THAT(query.get<std::vector<std::byte>>("value"),
+              ::testing::Eq(std::vector<std::byte>(16, std::byte{2})));
+}
+
+TEST_F(BindLifetimeTest, stringLiteralIsBoundWithoutTemporary) {
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", "literal");
+  query.execute();
+
+  EXPECT_THAT(query.get<std::string>("value"), ::testing::Eq("literal"));
+}
+
+TEST_F(BindLifetimeTest, ownedBlobIsFreedBySqliteOnce) {
+  {
+    auto query = Q{R"sql(select :val 'value')sql", m_conn,
+                   Database::QueryOptions{false}};
+    query.set("val", makeOwnedBlob("payload"));
+    query.execute();
+
+    const auto value = query.get<std::vector<std::byte>>("value");
+    EXPECT_THAT(value.size(), ::testing::Eq(7));
+    EXPECT_THAT(freedBlobs, ::testing::Eq(0));
+  }
+
+  EXPECT_THAT(freedBlobs, ::testing::Eq(1));
+}
+
+TEST_F(BindLifetimeTest, ownedBlobIsFreedWhenRebound) {
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", makeOwnedBlob("first"));
+  query.set("val", makeOwnedBlob("second"));
+
+  EXPECT_THAT(freedBlobs, ::testing::Eq(1));
+}
+
+TEST_F(BindLifetimeTest, ownedBlobIsFreedWhenBindFails) {
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+
+  EXPECT_THROW(query.set(Database::Parameter{5}, makeOwnedBlob("payload")),
+               Database::QueryError);
+  EXPECT_THAT(freedBlobs, ::testing::Eq(1));
+}
+
+} // namespace
@@ -0,0 +1,139 @@
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "database/BulkInserter.h"
+#include "database/Connection.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "database/RowMapping.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct SessionRow {
+  std::int64_t id = 0;
+  std::optional<std::string> payload;
+};
+
+} // namespace
+
+template <> struct Database::RowMapping<SessionRow> {
+  static constexpr auto fields =
+      std::tuple{Database::field("payload", &SessionRow::payload),
+                 Database::field("id", &SessionRow::id)};
+};
+
+namespace {
+
+using Q = Database::Query;
+
+constexpr auto insertSql =
+    R"sql(insert into session (id, payload) values (:id, :payload))sql";
+
+class BulkInserterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Q{R"sql(create table session (id integer primary key, payload text))sql",
+      m_conn}
+        .execute();
+  }
+
+  auto rowCount() -> int64_t {
+    auto query = Q{R"sql(select count(1) 'c' from session)sql", m_conn};
+    query.execute();
+    return query.get<int64_t>("c");
+  }
+
+  Database::Connection m_conn;
+};
+
+TEST_F(BulkInserterTest, insertsInChunks) {
+  auto inserter = Database::BulkInserter{m_conn, insertSql, 100};
+  for (auto i = 0; i < 1050; ++i)
+    inserter.insert(i, std::string{"payload"});
+  inserter.finish();
+
+  EXPECT_THAT(rowCount(), ::testing::Eq(1050));
+  EXPECT_THAT(inserter.stats().rows, ::testing::Eq(1050));
+  EXPECT_THAT(inserter.stats().transactions, ::testing::Eq(11));
+  EXPECT_FALSE(m_conn.isInTransaction());
+}
+
+TEST_F(BulkInserterTest, insertManyTuples) {
+  const auto rows = std::vector<std::tuple<int, std::string>>{
+      {1, "a"}, {2, "b"}, {3, "c"}};
+  {
+    auto inserter = Database::BulkInserter{m_conn, insertSql};
+    inserter.insertMany(rows);
+  }
+
+  auto query = Q{R"sql(select payload from session where id = 2)sql", m_conn};
+  query.execute();
+  EXPECT_THAT(query.get<std::string>("payload"), ::testing::Eq("b"));
+}
+
+TEST_F(BulkInserterTest, insertManyMappedStructs) {
+  const auto rows =
+      std::vector<SessionRow>{{1, "a"}, {2, std::nullopt}, {3, "c"}};
+  {
+    auto inserter = Database::BulkInserter{m_conn, insertSql};
+    inserter.insertMany(rows);
+  }
+
+  auto query =
+      Q{R"sql(select id, payload from session order by id)sql", m_conn};
+  auto inserted = std::vector<SessionRow>{};
+  EXPECT_THAT(query.fetchAllInto(inserted), ::testing::Eq(3u));
+  EXPECT_THAT(inserted[0].payload, ::testing::Eq("a"));
+  EXPECT_THAT(inserted[1].payload, ::testing::Eq(std::nullopt));
+  EXPECT_THAT(inserted[2].id, ::testing::Eq(3));
+}
+
+TEST_F(BulkInserterTest, failedRowRollsBackItsChunk) {
+  auto inserter = Database::BulkInserter{m_conn, insertSql, 10};
+  for (auto i = 0; i < 15; ++i)
+    inserter.insert(i, "payload");
+
+  EXPECT_THROW(inserter.insert(0, "duplicate"), Database::QueryError);
+  EXPECT_FALSE(m_conn.isInTransaction());
+  EXPECT_THAT(rowCount(), ::testing::Eq(10));
+
+  inserter.insert(100, "payload");
+  inserter.finish();
+  EXPECT_THAT(rowCount(), ::testing::Eq(11));
+}
+
+TEST_F(BulkInserterTest, unwindingRollsBackPendingChunk) {
+  try {
+    auto inserter = Database::BulkInserter{m_conn, insertSql, 10};
+    for (auto i = 0; i < 15; ++i)
+      inserter.insert(i, "payload");
+    throw std::runtime_error{"abort import"};
+  } catch (const std::runtime_error &) {
+  }
+
+  EXPECT_FALSE(m_conn.isInTransaction());
+  EXPECT_THAT(rowCount(), ::testing::Eq(10));
+}
+
+TEST_F(BulkInserterTest, joinsOuterTransaction) {
+  Q{"begin", m_conn}.execute();
+  {
+    auto inserter = Database::BulkInserter{m_conn, insertSql, 2};
+    for (auto i = 0; i < 5; ++i)
+      inserter.insert(i, "payload");
+    inserter.finish();
+    EXPECT_THAT(inserter.stats().transactions, ::testing::Eq(0));
+  }
+  EXPECT_TRUE(m_conn.isInTransaction());
+  Q{"rollback", m_conn}.execute();
+
+  EXPECT_THAT(rowCount(), ::testing::Eq(0));
+}
+
+} // namespace
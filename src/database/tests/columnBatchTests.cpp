@@ -0,0 +1,100 @@
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "database/ColumnBatch.h"
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+
+class ColumnBatchTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Q{R"sql(create table session (id integer primary key, user text, expires real, token blob))sql",
+      m_conn}
+        .execute();
+    auto insert = Q{R"sql(insert into session values (?, ?, ?, ?))sql", m_conn};
+    for (auto id = 0; id < rowCount; ++id) {
+      insert.bind(id, "user" + std::to_string(id),
+                  id % 3 ? std::optional<double>{id * 0.5} : std::nullopt,
+                  std::vector{std::byte(id)});
+      insert.execute();
+    }
+  }
+
+  static constexpr auto rowCount = 10;
+  Database::Connection m_conn;
+};
+
+TEST_F(ColumnBatchTest, fillsContiguousColumns) {
+  auto query = Q{
+      R"sql(select id, user, expires, token from session order by id)sql",
+      m_conn};
+
+  const auto batch =
+      query.fetchColumns<std::int64_t, std::string, std::optional<double>,
+                         std::vector<std::byte>>(100);
+
+  ASSERT_THAT(batch.rows(), ::testing::Eq(10u));
+  const auto &ids = batch.column<0>();
+  EXPECT_THAT(std::accumulate(ids.data(), ids.data() + ids.size(),
+                              std::int64_t{0}),
+              ::testing::Eq(45));
+
+  const auto &users = batch.column<1>();
+  EXPECT_THAT(users[0], ::testing::Eq("user0"));
+  EXPECT_THAT(users[9], ::testing::Eq("user9"));
+  EXPECT_THAT(users.offsets().size(), ::testing::Eq(11u));
+  EXPECT_THAT(users.bytes().size(), ::testing::Eq(users.offsets().back()));
+
+  const auto &expires = batch.column<2>();
+  EXPECT_TRUE(expires.isNull(0));
+  EXPECT_FALSE(expires.isNull(1));
+  EXPECT_THAT(expires.values()[1], ::testing::Eq(0.5));
+  EXPECT_THAT(expires.values()[3], ::testing::Eq(0.0));
+
+  const auto &tokens = batch.column<3>();
+  EXPECT_THAT(tokens[7].size(), ::testing::Eq(1u));
+  EXPECT_THAT(tokens[7][0], ::testing::Eq(std::byte{7}));
+}
+
+TEST_F(ColumnBatchTest, refillsBatchUntilExhausted) {
+  auto query = Q{R"sql(select id from session order by id)sql", m_conn};
+  auto batch = Database::ColumnBatch<int>{};
+
+  auto sizes = std::vector<std::size_t>{};
+  auto ids = std::vector<int>{};
+  while (query.fetchColumns(batch, 4)) {
+    sizes.push_back(batch.rows());
+    for (std::size_t row = 0; row < batch.rows(); ++row)
+      ids.push_back(batch.column<0>()[row]);
+  }
+
+  EXPECT_THAT(sizes, ::testing::ElementsAre(4, 4, 2));
+  EXPECT_THAT(ids.size(), ::testing::Eq(10u));
+  EXPECT_THAT(ids.back(), ::testing::Eq(9));
+  EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(ColumnBatchTest, nullableTextKeepsOffsetsAligned) {
+  auto query = Q{
+      R"sql(select column1 from (values ('ab'), (null), ('cde')))sql", m_conn};
+
+  const auto batch = query.fetchColumns<std::optional<std::string>>(10);
+  const auto &text = batch.column<0>();
+
+  EXPECT_THAT(text.valid(), ::testing::ElementsAre(1, 0, 1));
+  EXPECT_THAT(text.values()[0], ::testing::Eq("ab"));
+  EXPECT_THAT(text.values()[1], ::testing::Eq(""));
+  EXPECT_THAT(text.values()[2], ::testing::Eq("cde"));
+}
+
+} // namespace
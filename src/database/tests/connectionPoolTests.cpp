@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "database/ConnectionPool.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+using Q = Database::Query;
+
+constexpr auto databaseFile = "pool.db3";
+
+auto removeDatabase() -> void {
+  for (const auto suffix : {"", "-wal", "-shm"})
+    std::filesystem::remove(std::string{databaseFile} + suffix);
+}
+
+class ConnectionPoolTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    removeDatabase();
+    auto options = Database::ConnectionPoolOptions{};
+    options.readers = 2;
+    options.leaseTimeout = 50ms;
+    m_pool = std::make_unique<Database::ConnectionPool>(databaseFile, options);
+
+    auto writer = m_pool->acquireWriter();
+    Q{R"sql(create table session (id integer primary key))sql", *writer}
+        .execute();
+    Q{R"sql(insert into session values (1), (2), (3))sql", *writer}.execute();
+  }
+
+  void TearDown() override {
+    m_pool.reset();
+    removeDatabase();
+  }
+
+  std::unique_ptr<Database::ConnectionPool> m_pool;
+};
+
+TEST_F(ConnectionPoolTest, readerSeesCommittedWrites) {
+  auto reader = m_pool->acquireReader();
+  auto query = Q{R"sql(select count(1) 'c' from session)sql", *reader};
+  query.execute();
+
+  EXPECT_THAT(query.get<int64_t>("c"), ::testing::Eq(3));
+}
+
+TEST_F(ConnectionPoolTest, readerIsReadOnly) {
+  auto reader = m_pool->acquireReader();
+
+  EXPECT_THROW(Q(R"sql(insert into session values (4))sql", *reader).execute(),
+               Database::QueryError);
+}
+
+TEST_F(ConnectionPoolTest, expectThrowWhenNoReaderFree) {
+  auto first = m_pool->acquireReader();
+  auto second = m_pool->acquireReader();
+
+  EXPECT_THROW(m_pool->acquireReader(), Database::LeaseTimeout);
+  EXPECT_THAT(m_pool->metrics().timeouts, ::testing::Eq(1));
+}
+
+TEST_F(ConnectionPoolTest, writerIsExclusive) {
+  auto writer = m_pool->acquireWriter();
+
+  EXPECT_THROW(m_pool->acquireWriter(), Database::LeaseTimeout);
+}
+
+TEST_F(ConnectionPoolTest, returnedLeaseIsReused) {
+  { auto reader = m_pool->acquireReader(); }
+  { auto reader = m_pool->acquireReader(); }
+
+  const auto metrics = m_pool->metrics();
+  EXPECT_THAT(metrics.readerLeases, ::testing::Eq(2));
+  EXPECT_THAT(metrics.idleReaders, ::testing::Eq(2));
+}
+
+TEST_F(ConnectionPoolTest, waitingReaderGetsReleasedConnection) {
+  auto first = m_pool->acquireReader();
+  auto second = m_pool->acquireReader();
+
+  auto releaser = std::thread{[lease = std::move(first)]() mutable {
+    std::this_thread::sleep_for(10ms);
+    auto released = std::move(lease);
+  }};
+  auto third = m_pool->acquireReader(1s);
+  releaser.join();
+
+  EXPECT_THAT(m_pool->metrics().readerWaitMax, ::testing::Gt(0ns));
+}
+
+TEST_F(ConnectionPoolTest, parallelReadsWhileWriting) {
+  auto writer = m_pool->acquireWriter();
+  Q{"begin", *writer}.execute();
+  Q{R"sql(insert into session values (4))sql", *writer}.execute();
+
+  auto counts = std::vector<int64_t>(4);
+  auto threads = std::vector<std::thread>{};
+  for (auto i = 0; i < 4; ++i)
+    threads.emplace_back([this, &counts, i] {
+      auto reader = m_pool->acquireReader(1s);
+      auto query = Q{R"sql(select count(1) 'c' from session)sql", *reader};
+      query.execute();
+      counts[i] = query.get<int64_t>("c");
+    });
+  for (auto &thread : threads)
+    thread.join();
+  Q{"commit", *writer}.execute();
+
+  EXPECT_THAT(counts, ::testing::Each(3));
+}
+
+} // namespace
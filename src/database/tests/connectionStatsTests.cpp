@@ -0,0 +1,154 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "spdlog/sinks/ostream_sink.h"
+#include "spdlog/spdlog.h"
+
+#include "database/Connection.h"
+#include "database/ConnectionStats.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+using Q = Database::Query;
+using ::testing::Gt;
+using ::testing::HasSubstr;
+
+class ConnectionStatsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Q{R"sql(create table session (id integer primary key, note text))sql",
+      m_conn}
+        .execute();
+    Q{R"sql(insert into session values (1, 'a'), (2, 'b'))sql", m_conn}
+        .execute();
+  }
+
+  // Waits until the sampler has taken at least count samples.
+  static auto waitForSamples(const Database::ConnectionStatsSampler &sampler,
+                             std::uint64_t count) -> void {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (sampler.samples() < count &&
+           std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(1ms);
+  }
+
+  Database::Connection m_conn;
+};
+
+TEST_F(ConnectionStatsTest, reportsSchemaStatementAndCacheMemory) {
+  auto query = Q{R"sql(select note from session where id = ?)sql", m_conn};
+  query.bind(1);
+  ASSERT_TRUE(query.next());
+
+  const auto stats = m_conn.stats();
+  EXPECT_THAT(stats.schemaUsed, Gt(0));
+  EXPECT_THAT(stats.statementUsed, Gt(0));
+  EXPECT_THAT(stats.cacheUsed, Gt(0));
+  EXPECT_THAT(stats.cacheHits + stats.cacheMisses, Gt(0));
+  EXPECT_THAT(stats.process.memoryUsed, Gt(0));
+  EXPECT_THAT(stats.process.memoryHighwater,
+              ::testing::Ge(stats.process.memoryUsed));
+}
+
+TEST_F(ConnectionStatsTest, cachedStatementsCountAsStatementMemory) {
+  const auto before = m_conn.stats().statementUsed;
+  Q{R"sql(select count(*) from session where note like 'a%')sql", m_conn}
+      .execute();
+
+  EXPECT_THAT(m_conn.stats().statementUsed, Gt(before));
+}
+
+TEST_F(ConnectionStatsTest, toStringListsEveryFigure) {
+  const auto text = m_conn.stats().toString();
+  EXPECT_THAT(text, HasSubstr("cache_used="));
+  EXPECT_THAT(text, HasSubstr("lookaside_hits="));
+  EXPECT_THAT(text, HasSubstr("statement_used="));
+  EXPECT_THAT(text, HasSubstr("memory_used="));
+}
+
+TEST_F(ConnectionStatsTest, samplerFeedsCallback) {
+  auto mutex = std::mutex{};
+  auto last = Database::ConnectionStats{};
+  auto options = Database::ConnectionStatsSamplerOptions{};
+  options.interval = 1ms;
+  options.callback = [&](const Database::ConnectionStats &stats) {
+    const auto lock = std::lock_guard{mutex};
+    last = stats;
+  };
+
+  {
+    auto sampler = Database::ConnectionStatsSampler{m_conn, options};
+    waitForSamples(sampler, 2);
+    EXPECT_THAT(sampler.samples(), ::testing::Ge(2u));
+  }
+
+  const auto lock = std::lock_guard{mutex};
+  EXPECT_THAT(last.schemaUsed, Gt(0));
+}
+
+TEST_F(ConnectionStatsTest, samplerLogsWithoutCallback) {
+  auto output = std::ostringstream{};
+  auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(output);
+  sink->set_pattern("%l %v");
+  auto options = Database::ConnectionStatsSamplerOptions{};
+  options.interval = 1ms;
+  options.logger =
+      std::make_shared<spdlog::logger>("connectionStatsTest", sink);
+
+  {
+    auto sampler = Database::ConnectionStatsSampler{m_conn, options};
+    waitForSamples(sampler, 1);
+  }
+
+  options.logger->flush();
+  EXPECT_THAT(output.str(), HasSubstr("info connection stats cache_used="));
+}
+
+TEST_F(ConnectionStatsTest, samplerLogsCallbackErrorsAndKeepsSampling) {
+  auto output = std::ostringstream{};
+  auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(output);
+  sink->set_pattern("%l %v");
+  auto options = Database::ConnectionStatsSamplerOptions{};
+  options.interval = 1ms;
+  options.callback = [](const Database::ConnectionStats &) {
+    throw std::runtime_error{"callback broke"};
+  };
+  options.logger =
+      std::make_shared<spdlog::logger>("connectionStatsErrorTest", sink);
+
+  {
+    auto sampler = Database::ConnectionStatsSampler{m_conn, options};
+    waitForSamples(sampler, 2);
+    EXPECT_THAT(sampler.samples(), ::testing::Ge(2u));
+  }
+
+  options.logger->flush();
+  EXPECT_THAT(output.str(),
+              HasSubstr("error connection stats callback failed: "
+                        "callback broke"));
+}
+
+TEST_F(ConnectionStatsTest, samplerStopsPromptly) {
+  auto options = Database::ConnectionStatsSamplerOptions{};
+  options.interval = 1h;
+  options.callback = [](const Database::ConnectionStats &) {};
+
+  const auto start = std::chrono::steady_clock::now();
+  {
+    auto sampler = Database::ConnectionStatsSampler{m_conn, options};
+    EXPECT_THAT(sampler.samples(), ::testing::Eq(0u));
+  }
+  EXPECT_THAT(std::chrono::steady_clock::now() - start, ::testing::Lt(1s));
+}
+
+} // namespace
@@ -1,7 +1,12 @@
 #include "database/Connection.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <cstdint>
 #include <filesystem>
+#include <string>
 
 namespace {
 
@@ -14,4 +19,75 @@ TEST(ConnectionTests, createConnectionWithString) {
   std::filesystem::remove("temp.db3");
 }
 
+auto readPragma(Database::Connection &conn, std::string_view name)
+    -> std::string {
+  auto query = Database::Query{std::string{"pragma "}.append(name), conn};
+  query.execute();
+  return query.get<std::string>(Database::Column{0});
+}
+
+TEST(ConnectionTests, createConnectionWithOptions) {
+  const auto file = "options.db3";
+  {
+    auto options = Database::ConnectionOptions::highThroughput();
+    options.pageSize = 8192;
+    auto conn = Database::Connection(file, options);
+
+    EXPECT_THAT(readPragma(conn, "journal_mode"), ::testing::Eq("wal"));
+    EXPECT_THAT(readPragma(conn, "synchronous"), ::testing::Eq("1"));
+    EXPECT_THAT(readPragma(conn, "cache_size"), ::testing::Eq("-65536"));
+    EXPECT_THAT(readPragma(conn, "temp_store"), ::testing::Eq("2"));
+    EXPECT_THAT(readPragma(conn, "busy_timeout"), ::testing::Eq("5000"));
+    EXPECT_THAT(readPragma(conn, "page_size"), ::testing::Eq("8192"));
+  }
+  std::filesystem::remove(file);
+  std::filesystem::remove(std::string{file} + "-wal");
+  std::filesystem::remove(std::string{file} + "-shm");
+}
+
+TEST(ConnectionTests, reopenKeepsPageSizeOfExistingDatabase) {
+  const auto file = "pagesize.db3";
+  auto pageSize = std::string{};
+  {
+    auto conn = Database::Connection(file, Database::ConnectionOptions{});
+    Database::Query{"create table foo (id integer)", conn}.execute();
+    pageSize = readPragma(conn, "page_size");
+  }
+  {
+    auto options = Database::ConnectionOptions{};
+    options.pageSize = pageSize == "8192" ? 16384 : 8192;
+    auto conn = Database::Connection(file, options);
+
+    EXPECT_THAT(readPragma(conn, "page_size"), ::testing::Eq(pageSize));
+  }
+  std::filesystem::remove(file);
+}
+
+TEST(ConnectionTests, mmapSizeAboveLimitIsCapped) {
+  const auto file = "mmap.db3";
+  {
+    auto options = Database::ConnectionOptions{};
+    options.mmapSize = std::int64_t{1} << 50;
+    auto conn = Database::Connection(file, options);
+
+    EXPECT_THAT(std::stoll(readPragma(conn, "mmap_size")),
+                ::testing::Le(*options.mmapSize));
+  }
+  std::filesystem::remove(file);
+}
+
+TEST(ConnectionTests, unsetOptionsKeepDefaults) {
+  auto conn = Database::Connection(":memory:", Database::ConnectionOptions{});
+
+  EXPECT_THAT(readPragma(conn, "journal_mode"), ::testing::Eq("memory"));
+}
+
+TEST(ConnectionTests, expectThrowWhenOptionCannotBeApplied) {
+  auto options = Database::ConnectionOptions{};
+  options.journalMode = Database::JournalMode::Wal;
+
+  EXPECT_THROW(Database::Connection(":memory:", options),
+               Database::ErrorOpeningDatabase);
+}
+
 } // namespace
@@ -0,0 +1,128 @@
+#include <array>
+#include <cstddef>
+#include <optional>
+
+#include "database/Connection.h"
+#include "database/MemoryConfig.h"
+#include "database/Query.h"
+#include "database/SizeClassAllocator.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Gt;
+
+auto runLookups(Database::Connection &conn) -> void {
+  Q{R"sql(create table session (id integer primary key, note text))sql", conn}
+      .execute();
+  Q{R"sql(insert into session
+          with recursive ids(id) as
+            (select 0 union all select id + 1 from ids where id < 999)
+          select id, 'note' from ids)sql",
+    conn}
+      .execute();
+  for (auto id = 0; id < 100; ++id) {
+    auto query = Q{R"sql(select note from session where id = ?)sql", conn,
+                   Database::QueryOptions{false}};
+    query.bind(id);
+    ASSERT_TRUE(query.next());
+  }
+}
+
+TEST(SizeClassAllocatorTest, classesCoverEverySizeWithBoundedWaste) {
+  auto previous = 0;
+  for (std::size_t size = 8; size <= 64 * 1024; size += 8) {
+    const auto sizeClass = Database::detail::sizeClassOf(size);
+    const auto classSize = Database::detail::sizeOfClass(sizeClass);
+    ASSERT_THAT(sizeClass, Ge(previous)) << size;
+    ASSERT_THAT(classSize, Ge(size)) << size;
+    ASSERT_THAT(classSize - size, ::testing::Le(size / 4 + 8)) << size;
+    previous = sizeClass;
+  }
+  EXPECT_THAT(previous, Eq(47));
+  EXPECT_THAT(Database::detail::sizeClassOf(64 * 1024 + 8), Eq(-1));
+}
+
+TEST(SizeClassAllocatorTest, freedBlocksAreReused) {
+  const auto methods = Database::sizeClassAllocator();
+  const auto first = methods.xMalloc(100);
+  ASSERT_NE(first, nullptr);
+  EXPECT_THAT(methods.xSize(first), Eq(methods.xRoundup(100)));
+  methods.xFree(first);
+
+  const auto before = Database::sizeClassAllocatorStats();
+  const auto second = methods.xMalloc(99);
+  EXPECT_THAT(second, Eq(first));
+  EXPECT_THAT(Database::sizeClassAllocatorStats().hits, Eq(before.hits + 1));
+
+  const auto grown = methods.xRealloc(second, 5000);
+  ASSERT_NE(grown, nullptr);
+  EXPECT_THAT(methods.xSize(grown), Ge(5000));
+  methods.xFree(grown);
+}
+
+class MemoryConfigTest : public ::testing::Test {
+protected:
+  void TearDown() override { Database::configureMemory({}); }
+};
+
+TEST_F(MemoryConfigTest, poolAllocatorAndPageCacheServeConnections) {
+  auto options = Database::MemoryOptions{};
+  options.allocator = Database::sizeClassAllocator();
+  options.pageCache = Database::PageCacheOptions{4096, 64};
+  Database::configureMemory(options);
+
+  const auto before = Database::sizeClassAllocatorStats();
+  {
+    auto conn = Database::Connection{};
+    runLookups(conn);
+    EXPECT_THAT(conn.stats().process.pageCacheUsed, Gt(0));
+  }
+
+  const auto after = Database::sizeClassAllocatorStats();
+  EXPECT_THAT(after.hits, Gt(before.hits));
+  EXPECT_THAT(after.cachedBytes, Gt(0u));
+}
+
+TEST_F(MemoryConfigTest, defaultsCanBeRestored) {
+  auto options = Database::MemoryOptions{};
+  options.allocator = Database::sizeClassAllocator();
+  Database::configureMemory(options);
+  Database::configureMemory({});
+
+  const auto before = Database::sizeClassAllocatorStats();
+  {
+    auto conn = Database::Connection{};
+    runLookups(conn);
+  }
+  const auto after = Database::sizeClassAllocatorStats();
+  EXPECT_THAT(after.hits + after.misses, Eq(before.hits + before.misses));
+}
+
+TEST(LookasideTest, callerBufferServesSmallAllocations) {
+  if (sqlite3_compileoption_used("OMIT_LOOKASIDE"))
+    GTEST_SKIP() << "SQLite built without lookaside";
+
+  alignas(8) static std::array<std::byte, 256 * 128> buffer;
+  auto options = Database::ConnectionOptions{};
+  options.lookaside = Database::LookasideOptions{256, 128, buffer.data()};
+
+  auto conn = Database::Connection{":memory:", options};
+  runLookups(conn);
+  EXPECT_THAT(conn.stats().lookasideHits, Gt(0));
+}
+
+TEST(LookasideTest, zeroSlotsDisableLookaside) {
+  auto options = Database::ConnectionOptions{};
+  options.lookaside = Database::LookasideOptions{0, 0, nullptr};
+
+  auto conn = Database::Connection{":memory:", options};
+  runLookups(conn);
+  EXPECT_THAT(conn.stats().lookasideHits, Eq(0));
+}
+
+} // namespace
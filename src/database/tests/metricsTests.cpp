@@ -0,0 +1,171 @@
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "database/Connection.h"
+#include "database/Metrics.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+using namespace std::chrono_literals;
+
+class MetricsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Q{R"sql(create table session (id integer primary key, note text))sql",
+      m_conn}
+        .execute();
+    Q{R"sql(insert into session values (1, 'a'), (2, 'b'), (3, 'a'))sql",
+      m_conn}
+        .execute();
+    Database::Metrics::reset();
+    Database::Metrics::setEnabled(true);
+  }
+
+  void TearDown() override {
+    Database::Metrics::setEnabled(false);
+    Database::Metrics::reset();
+  }
+
+  static auto latenciesOf(const char *sql) -> Database::QueryLatencies {
+    const auto snapshot = Database::Metrics::snapshot();
+    for (const auto &query : snapshot.queries)
+      if (query.sql.find(sql) != std::string::npos)
+        return query;
+    ADD_FAILURE() << "no latencies for " << sql;
+    return {};
+  }
+
+  Database::Connection m_conn;
+};
+
+TEST(LatencyHistogramTest, bucketsAreWithinOneSixteenth) {
+  for (const auto value : {0ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull,
+                           (1ull << 40) + 12345}) {
+    const auto bucket = Database::LatencyHistogram::bucketOf(value);
+    const auto upper = Database::LatencyHistogram::bucketUpperBound(bucket);
+    EXPECT_THAT(upper, ::testing::Ge(value));
+    EXPECT_THAT(upper - value, ::testing::Le(value / 16));
+  }
+}
+
+TEST(LatencyHistogramTest, percentilesAndMax) {
+  auto histogram = Database::LatencyHistogram{};
+  for (auto i = 1; i <= 100; ++i)
+    histogram.record(std::chrono::microseconds{i});
+
+  EXPECT_THAT(histogram.count(), ::testing::Eq(100u));
+  EXPECT_THAT(histogram.max(), ::testing::Eq(100us));
+  EXPECT_THAT(histogram.mean(), ::testing::Eq(50500ns));
+  EXPECT_THAT(histogram.percentile(0.5), ::testing::AllOf(
+                                             ::testing::Ge(50us),
+                                             ::testing::Le(50us * 17 / 16)));
+  EXPECT_THAT(histogram.percentile(1.0), ::testing::Eq(100us));
+  EXPECT_THAT(Database::LatencyHistogram{}.percentile(0.5),
+              ::testing::Eq(0ns));
+}
+
+TEST(LatencyHistogramTest, mergeAddsCounts) {
+  auto first = Database::LatencyHistogram{};
+  auto second = Database::LatencyHistogram{};
+  first.record(10us);
+  second.record(20us);
+  second.record(30us);
+
+  first.merge(second);
+  EXPECT_THAT(first.count(), ::testing::Eq(3u));
+  EXPECT_THAT(first.max(), ::testing::Eq(30us));
+  EXPECT_THAT(first.mean(), ::testing::Eq(20us));
+}
+
+TEST_F(MetricsTest, queryRecordsPrepareFirstRowAndExecute) {
+  auto query = Q{R"sql(select id from session where note = ?)sql", m_conn};
+  for (const auto note : {"a", "b"}) {
+    query.bind(note);
+    while (query.next()) {
+    }
+  }
+
+  const auto latencies = latenciesOf("where note");
+  EXPECT_THAT(latencies.prepare.count(), ::testing::Eq(1u));
+  EXPECT_THAT(latencies.firstRow.count(), ::testing::Eq(2u));
+  EXPECT_THAT(latencies.execute.count(), ::testing::Eq(2u));
+  EXPECT_THAT(latencies.execute.max(),
+              ::testing::Ge(latencies.firstRow.max()));
+}
+
+TEST_F(MetricsTest, threadsAreMergedInSnapshot) {
+  const auto run = [] {
+    auto conn = Database::Connection{};
+    for (auto i = 0; i < 5; ++i)
+      Q{R"sql(select 42 as merged)sql", conn}.execute();
+  };
+  auto first = std::thread{run};
+  auto second = std::thread{run};
+  first.join();
+  second.join();
+
+  const auto latencies = latenciesOf("as merged");
+  EXPECT_THAT(latencies.firstRow.count(), ::testing::Eq(10u));
+  EXPECT_THAT(latencies.execute.count(), ::testing::Eq(10u));
+}
+
+TEST_F(MetricsTest, runFinishedOnAnotherThreadIsRecorded) {
+  auto query = Q{R"sql(select id as moved from session)sql", m_conn};
+  // The thread's histograms are retired once it exits.
+  std::thread{[&query] { query.next(); }}.join();
+  while (query.next()) {
+  }
+
+  const auto latencies = latenciesOf("as moved");
+  EXPECT_THAT(latencies.firstRow.count(), ::testing::Eq(1u));
+  EXPECT_THAT(latencies.execute.count(), ::testing::Eq(1u));
+}
+
+TEST_F(MetricsTest, nothingIsRecordedWhileDisabled) {
+  Database::Metrics::setEnabled(false);
+  Q{R"sql(select count(*) as disabled from session)sql", m_conn}.execute();
+
+  for (const auto &query : Database::Metrics::snapshot().queries)
+    EXPECT_THAT(query.sql, ::testing::Not(::testing::HasSubstr("disabled")));
+}
+
+TEST_F(MetricsTest, resetZeroesHistograms) {
+  Q{R"sql(select count(*) as resetted from session)sql", m_conn}.execute();
+  Database::Metrics::reset();
+
+  const auto latencies = latenciesOf("as resetted");
+  EXPECT_THAT(latencies.execute.count(), ::testing::Eq(0u));
+}
+
+TEST_F(MetricsTest, resetZeroesHistogramsOfExitedThreads) {
+  std::thread{[] {
+    auto conn = Database::Connection{};
+    Q{R"sql(select 42 as exited)sql", conn}.execute();
+  }}.join();
+  EXPECT_THAT(latenciesOf("as exited").execute.count(), ::testing::Eq(1u));
+
+  Database::Metrics::reset();
+
+  EXPECT_THAT(latenciesOf("as exited").execute.count(), ::testing::Eq(0u));
+}
+
+TEST_F(MetricsTest, dumpsTextAndJson) {
+  Q{R"sql(select "quoted" from session)sql", m_conn}.execute();
+
+  const auto snapshot = Database::Metrics::snapshot();
+  EXPECT_THAT(snapshot.toText(),
+              ::testing::HasSubstr("select \"quoted\" from session\n"));
+  EXPECT_THAT(snapshot.toText(), ::testing::HasSubstr("execute   n=1 p50="));
+
+  const auto json = snapshot.toJson();
+  EXPECT_THAT(json, ::testing::StartsWith(R"({"queries":[)"));
+  EXPECT_THAT(json, ::testing::HasSubstr(R"(select \"quoted\" from session)"));
+  EXPECT_THAT(json, ::testing::HasSubstr(R"("execute":{"count":1,"p50_ns":)"));
+}
+
+} // namespace
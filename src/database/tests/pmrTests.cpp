@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/RowMapping.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+using ::testing::Eq;
+using ::testing::Gt;
+
+// Longer than any small string buffer.
+constexpr auto longNote = "a note that is too long to be stored inline";
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+  std::size_t allocations = 0;
+
+private:
+  auto do_allocate(std::size_t bytes, std::size_t alignment)
+      -> void * override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  auto do_deallocate(void *memory, std::size_t bytes, std::size_t alignment)
+      -> void override {
+    std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+  }
+  auto do_is_equal(const std::pmr::memory_resource &other) const noexcept
+      -> bool override {
+    return this == &other;
+  }
+};
+
+struct PmrSessionRow {
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  explicit PmrSessionRow(const allocator_type &allocator = {})
+      : note(allocator), data(allocator) {}
+  PmrSessionRow(PmrSessionRow &&other, const allocator_type &allocator)
+      : id(other.id), note(std::move(other.note), allocator),
+        data(std::move(other.data), allocator) {}
+
+  std::int64_t id = 0;
+  std::pmr::string note;
+  std::pmr::vector<std::byte> data;
+};
+
+} // namespace
+
+template <> struct Database::RowMapping<PmrSessionRow> {
+  static constexpr auto fields =
+      std::tuple{Database::field("id", &PmrSessionRow::id),
+                 Database::field("note", &PmrSessionRow::note),
+                 Database::field("data", &PmrSessionRow::data)};
+};
+
+namespace {
+
+class PmrTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Q{R"sql(create table session (id integer primary key, note text, data blob))sql",
+      m_conn}
+        .execute();
+    auto insert =
+        Q{R"sql(insert into session values (?, ?, x'0102030405'))sql", m_conn};
+    for (auto id = 1; id <= 3; ++id) {
+      insert.bind(id, longNote);
+      insert.execute();
+    }
+    Q{R"sql(insert into session values (4, null, null))sql", m_conn}
+        .execute();
+  }
+
+  Database::Connection m_conn;
+  CountingResource m_resource;
+};
+
+TEST_F(PmrTest, getAllocatesFromResource) {
+  auto query = Q{R"sql(select note, data from session where id = 1)sql",
+                 m_conn};
+  ASSERT_TRUE(query.next());
+
+  const auto note = query.get<std::pmr::string>("note", &m_resource);
+  EXPECT_THAT(note, Eq(longNote));
+  EXPECT_THAT(note.get_allocator().resource(), Eq(&m_resource));
+
+  const auto data =
+      query.get<std::pmr::vector<std::byte>>(Database::Column{1}, &m_resource);
+  EXPECT_THAT(data.size(), Eq(5u));
+  EXPECT_THAT(m_resource.allocations, Eq(2u));
+}
+
+TEST_F(PmrTest, getWithoutResourceUsesDefault) {
+  auto query = Q{R"sql(select note from session where id = 1)sql", m_conn};
+  ASSERT_TRUE(query.next());
+
+  const auto note = query.get<std::pmr::string>(Database::Column{0});
+  EXPECT_THAT(note, Eq(longNote));
+  EXPECT_THAT(note.get_allocator().resource(),
+              Eq(std::pmr::get_default_resource()));
+}
+
+TEST_F(PmrTest, optionalIsEmptyForNull) {
+  auto query = Q{R"sql(select note from session where id = 4)sql", m_conn};
+  ASSERT_TRUE(query.next());
+
+  EXPECT_THAT(query.get<std::optional<std::pmr::string>>("note", &m_resource),
+              Eq(std::nullopt));
+  EXPECT_THAT(m_resource.allocations, Eq(0u));
+}
+
+TEST_F(PmrTest, getIntoKeepsBufferResource) {
+  auto query = Q{R"sql(select note from session where id = 1)sql", m_conn};
+  ASSERT_TRUE(query.next());
+
+  auto note = std::pmr::string{&m_resource};
+  EXPECT_TRUE(query.getInto("note", note));
+  EXPECT_THAT(note, Eq(longNote));
+  EXPECT_THAT(m_resource.allocations, Eq(1u));
+}
+
+TEST_F(PmrTest, fetchAllIntoAllocatesRowsFromArena) {
+  auto query =
+      Q{R"sql(select id, note, data from session order by id)sql", m_conn};
+
+  auto rows = std::pmr::vector<PmrSessionRow>{&m_resource};
+  EXPECT_THAT(query.fetchAllInto(rows), Eq(4u));
+
+  ASSERT_THAT(rows.size(), Eq(4u));
+  EXPECT_THAT(rows[2].id, Eq(3));
+  EXPECT_THAT(rows[2].note, Eq(longNote));
+  EXPECT_THAT(rows[2].data.size(), Eq(5u));
+  EXPECT_TRUE(rows[3].note.empty());
+  for (const auto &row : rows)
+    EXPECT_THAT(row.note.get_allocator().resource(), Eq(&m_resource));
+}
+
+TEST_F(PmrTest, fetchAllIntoWorksWithMonotonicBuffer) {
+  auto buffer = std::vector<std::byte>(16 * 1024);
+  auto arena = std::pmr::monotonic_buffer_resource{
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+  auto rows = std::pmr::vector<PmrSessionRow>{&arena};
+
+  auto query =
+      Q{R"sql(select id, note, data from session order by id)sql", m_conn};
+  EXPECT_THAT(query.fetchAllInto(rows), Eq(4u));
+  EXPECT_THAT(rows[0].note, Eq(longNote));
+}
+
+TEST_F(PmrTest, uncachedColumnNamesUseQueryResource) {
+  auto options = Database::QueryOptions{};
+  options.useStatementCache = false;
+  options.memoryResource = &m_resource;
+
+  auto query = Q{R"sql(select id, note from session where id = 1)sql", m_conn,
+                 options};
+  EXPECT_THAT(m_resource.allocations, Gt(0u));
+  ASSERT_TRUE(query.next());
+  EXPECT_THAT(query.get<std::string>("NOTE"), Eq(longNote));
+}
+
+TEST_F(PmrTest, cachedColumnNamesIgnoreQueryResource) {
+  auto options = Database::QueryOptions{};
+  options.memoryResource = &m_resource;
+
+  auto query = Q{R"sql(select id, note from session where id = 1)sql", m_conn,
+                 options};
+  EXPECT_THAT(m_resource.allocations, Eq(0u));
+  ASSERT_TRUE(query.next());
+  EXPECT_THAT(query.get<std::int64_t>("id"), Eq(1));
+}
+
+} // namespace
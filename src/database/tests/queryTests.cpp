@@ -167,4 +167,217 @@ TEST_F(QueryTest, setValue_expectThrowWhenNoParameter) {
   EXPECT_THROW(query.set("value", 1), Database::NoSuchSqlParameter);
 }
 
+TEST_F(QueryTest, next_iteratesAllRows) {
+  auto query =
+      Q{R"sql(select column1 'id' from (values (1), (2), (3)))sql", m_conn};
+
+  auto ids = std::vector<int64_t>{};
+  while (query.next())
+    ids.push_back(query.get<int64_t>("id"));
+
+  EXPECT_THAT(ids, ::testing::ElementsAre(1, 2, 3));
+  EXPECT_FALSE(query.next());
+}
+
+TEST_F(QueryTest, next_emptyResult) {
+  auto query = Q{R"sql(select 1 'id' where 0)sql", m_conn};
+
+  EXPECT_FALSE(query.next());
+}
+
+TEST_F(QueryTest, rows_rangeFor) {
+  auto query =
+      Q{R"sql(select column1 'id' from (values (1), (2), (3)))sql", m_conn};
+
+  auto ids = std::vector<int64_t>{};
+  for (auto &row : query.rows())
+    ids.push_back(row.get<int64_t>("id"));
+
+  EXPECT_THAT(ids, ::testing::ElementsAre(1, 2, 3));
+}
+
+TEST_F(QueryTest, rows_startAtCurrentRowAfterExecute) {
+  auto query =
+      Q{R"sql(select column1 'id' from (values (1), (2)))sql", m_conn};
+  query.execute();
+
+  auto ids = std::vector<int64_t>{};
+  for (auto &row : query.rows())
+    ids.push_back(row.get<int64_t>("id"));
+
+  EXPECT_THAT(ids, ::testing::ElementsAre(1, 2));
+}
+
+TEST_F(QueryTest, execute_expectThrowOnConstraintViolation) {
+  Q{R"sql(create table foo (id integer primary key))sql", m_conn}.execute();
+  Q{R"sql(insert into foo values (1))sql", m_conn}.execute();
+
+  auto query = Q{R"sql(insert into foo values (1))sql", m_conn};
+  EXPECT_THROW(query.execute(), Database::QueryError);
+}
+
+TEST_F(QueryTest, execute_reexecuteWithNewBinding) {
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+
+  for (auto i = 0; i < 3; ++i) {
+    query.set("val", i);
+    query.execute();
+
+    EXPECT_THAT(query.get<int64_t>("value"), ::testing::Eq(i));
+  }
+}
+
+TEST_F(QueryTest, execute_reexecuteKeepsBindings) {
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", 7);
+  query.execute();
+  query.execute();
+
+  EXPECT_THAT(query.get<int64_t>("value"), ::testing::Eq(7));
+}
+
+TEST_F(QueryTest, reset_rewindsCursor) {
+  auto query =
+      Q{R"sql(select column1 'id' from (values (1), (2)))sql", m_conn};
+  while (query.next()) {
+  }
+  query.reset();
+
+  ASSERT_TRUE(query.next());
+  EXPECT_THAT(query.get<int64_t>("id"), ::testing::Eq(1));
+}
+
+TEST_F(QueryTest, clearBindings_setsParametersToNull) {
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", 1);
+  query.execute();
+  query.clearBindings();
+  query.execute();
+
+  EXPECT_THAT(query.get<std::optional<int64_t>>("value"),
+              ::testing::Eq(std::nullopt));
+}
+
+TEST_F(QueryTest, execute_reexecuteInsert) {
+  Q{R"sql(create table foo (id integer))sql", m_conn}.execute();
+
+  auto insert = Q{R"sql(insert into foo values (:id))sql", m_conn};
+  for (auto i = 0; i < 5; ++i) {
+    insert.set("id", i);
+    insert.execute();
+  }
+
+  auto count = Q{R"sql(select count(1) 'c' from foo)sql", m_conn};
+  count.execute();
+  EXPECT_THAT(count.get<int64_t>("c"), ::testing::Eq(5));
+}
+
+TEST_F(QueryTest, get_columnNameIsCaseInsensitive) {
+  auto query = Q{R"sql(select 1 'Id')sql", m_conn};
+  query.execute();
+
+  EXPECT_THAT(query.get<int64_t>("id"), ::testing::Eq(1));
+  EXPECT_THAT(query.get<int64_t>("ID"), ::testing::Eq(1));
+}
+
+TEST_F(QueryTest, get_duplicatedColumnResolvesToFirst) {
+  auto query = Q{R"sql(select 1 'id', 2 'id')sql", m_conn};
+  query.execute();
+
+  EXPECT_THAT(query.get<int64_t>("id"), ::testing::Eq(1));
+}
+
+TEST_F(QueryTest, get_expectThrowWhenNoColumn) {
+  auto query = Q{R"sql(select 1 'id')sql", m_conn};
+  query.execute();
+
+  EXPECT_THROW(query.get<int64_t>("value"), Database::NoSuchColumn);
+}
+
+TEST_F(QueryTest, get_byColumnHandle) {
+  auto query = Q{
+      R"sql(select column1 'a', column2 'b' from (values (1, 'x'), (2, 'y')))sql",
+      m_conn};
+  const auto b = query.column("b");
+
+  auto values = std::vector<std::string>{};
+  while (query.next())
+    values.push_back(query.get<std::string>(b));
+
+  EXPECT_THAT(b.index, ::testing::Eq(1));
+  EXPECT_THAT(values, ::testing::ElementsAre("x", "y"));
+}
+
+TEST_F(QueryTest, getColumnValue_stringView) {
+  auto query = Q(R"sql(select 'field value' id)sql", m_conn);
+  query.execute();
+
+  EXPECT_EQ(query.get<std::string_view>("id"), "field value");
+}
+
+TEST_F(QueryTest, getColumnValue_byteSpan) {
+  const auto value = std::vector<std::byte>{std::byte{1}, std::byte{2}};
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", value);
+  query.execute();
+
+  const auto span = query.get<Database::ByteSpan>("value");
+  EXPECT_THAT(std::vector<std::byte>(span.begin(), span.end()),
+              ::testing::Eq(value));
+}
+
+TEST_F(QueryTest, getColumnValue_optStringView) {
+  auto query = Q{R"sql(select null 'value')sql", m_conn};
+  query.execute();
+
+  EXPECT_THAT(query.get<std::optional<std::string_view>>("value"),
+              ::testing::Eq(std::nullopt));
+}
+
+TEST_F(QueryTest, getColumnValue_value) {
+  auto query =
+      Q{R"sql(select 1 'i', 1.5 'd', 'text' 't', x'01' 'b', null 'n')sql",
+        m_conn};
+  query.execute();
+
+  using Database::Value;
+  EXPECT_THAT(query.columnCount(), ::testing::Eq(5));
+  EXPECT_THAT(query.get<Value>("i"), ::testing::Eq(Value{std::int64_t{1}}));
+  EXPECT_THAT(query.get<Value>("d"), ::testing::Eq(Value{1.5}));
+  EXPECT_THAT(query.get<Value>("t"), ::testing::Eq(Value{"text"}));
+  EXPECT_THAT(query.get<Value>("b"),
+              ::testing::Eq(Value{std::vector{std::byte{1}}}));
+  EXPECT_THAT(query.get<Value>("n"), ::testing::Eq(Value{nullptr}));
+}
+
+TEST_F(QueryTest, getInto_reusesBuffer) {
+  auto query = Q{
+      R"sql(select column1 'value' from (values ('abc'), ('de'), (null)))sql",
+      m_conn};
+  const auto column = query.column("value");
+  auto buffer = std::string{};
+  buffer.reserve(64);
+  const auto capacity = buffer.capacity();
+
+  auto values = std::vector<std::string>{};
+  auto notNull = std::vector<bool>{};
+  while (query.next()) {
+    notNull.push_back(query.getInto(column, buffer));
+    values.push_back(buffer);
+  }
+
+  EXPECT_THAT(values, ::testing::ElementsAre("abc", "de", ""));
+  EXPECT_THAT(notNull, ::testing::ElementsAre(true, true, false));
+  EXPECT_THAT(buffer.capacity(), ::testing::Eq(capacity));
+}
+
+TEST_F(QueryTest, getInto_blob) {
+  auto query = Q{R"sql(select randomblob(32) 'value')sql", m_conn};
+  query.execute();
+
+  auto buffer = std::vector<std::byte>{};
+  EXPECT_TRUE(query.getInto("value", buffer));
+  EXPECT_THAT(buffer.size(), ::testing::Eq(32));
+}
+
 } // namespace
\ No newline at end of file
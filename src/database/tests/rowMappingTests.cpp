@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "database/Connection.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "database/RowMapping.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct SessionRow {
+  std::int64_t id = 0;
+  std::string user;
+  std::optional<double> score;
+};
+
+} // namespace
+
+template <> struct Database::RowMapping<SessionRow> {
+  static constexpr auto fields =
+      std::tuple{Database::field("id", &SessionRow::id),
+                 Database::field("user", &SessionRow::user),
+                 Database::field("score", &SessionRow::score)};
+};
+
+namespace {
+
+using Q = Database::Query;
+
+class RowMappingTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Q{R"sql(create table session (id integer primary key, user text, score real))sql",
+      m_conn}
+        .execute();
+    Q{R"sql(insert into session values (1, 'alice', 0.5), (2, 'bob', null))sql",
+      m_conn}
+        .execute();
+  }
+
+  Database::Connection m_conn;
+};
+
+TEST_F(RowMappingTest, asReadsCurrentRow) {
+  auto query =
+      Q{R"sql(select id, user, score from session where id = 1)sql", m_conn};
+  query.execute();
+
+  const auto row = query.as<SessionRow>();
+
+  EXPECT_THAT(row.id, ::testing::Eq(1));
+  EXPECT_THAT(row.user, ::testing::Eq("alice"));
+  EXPECT_THAT(row.score, ::testing::Optional(0.5));
+}
+
+TEST_F(RowMappingTest, rowsAsMapsEveryRowAndNulls) {
+  // Column order differs from member order.
+  auto query =
+      Q{R"sql(select score, user, id from session order by id)sql", m_conn};
+
+  auto rows = std::vector<SessionRow>{};
+  for (const auto &row : query.rowsAs<SessionRow>())
+    rows.push_back(row);
+
+  ASSERT_THAT(rows.size(), ::testing::Eq(2u));
+  EXPECT_THAT(rows[1].id, ::testing::Eq(2));
+  EXPECT_THAT(rows[1].user, ::testing::Eq("bob"));
+  EXPECT_THAT(rows[1].score, ::testing::Eq(std::nullopt));
+}
+
+TEST_F(RowMappingTest, rowsAsOnEmptyResult) {
+  auto query = Q{R"sql(select id, user, score from session where id < 0)sql",
+                 m_conn};
+
+  auto count = 0;
+  for ([[maybe_unused]] const auto &row : query.rowsAs<SessionRow>())
+    ++count;
+
+  EXPECT_THAT(count, ::testing::Eq(0));
+}
+
+TEST_F(RowMappingTest, mapperIsReusedAcrossExecutions) {
+  auto query = Q{R"sql(select id, user, score from session where id = :id)sql",
+                 m_conn};
+  const auto mapper = Database::RowMapper<SessionRow>{query};
+
+  auto users = std::vector<std::string>{};
+  for (auto id : {2, 1}) {
+    query.set("id", id);
+    query.execute();
+    users.push_back(mapper.read(query).user);
+  }
+
+  EXPECT_THAT(users, ::testing::ElementsAre("bob", "alice"));
+}
+
+TEST_F(RowMappingTest, expectThrowWhenMappedColumnMissing) {
+  auto query = Q{R"sql(select id, user from session)sql", m_conn};
+
+  EXPECT_THROW(Database::RowMapper<SessionRow>{query}, Database::NoSuchColumn);
+}
+
+} // namespace
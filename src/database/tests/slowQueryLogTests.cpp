@@ -0,0 +1,116 @@
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include "spdlog/sinks/ostream_sink.h"
+#include "spdlog/spdlog.h"
+
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+using Q = Database::Query;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+class SlowQueryLogTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(m_output);
+    sink->set_pattern("%l %v");
+    m_logger = std::make_shared<spdlog::logger>("slowQueryLogTest", sink);
+    m_logger->set_level(spdlog::level::trace);
+  }
+
+  auto options() const -> Database::SlowQueryLogOptions {
+    auto options = Database::SlowQueryLogOptions{};
+    options.logger = m_logger;
+    return options;
+  }
+
+  auto output() -> std::string {
+    m_logger->flush();
+    return m_output.str();
+  }
+
+  std::ostringstream m_output;
+  std::shared_ptr<spdlog::logger> m_logger;
+  Database::Connection m_conn;
+};
+
+TEST_F(SlowQueryLogTest, logsStatementsAboveThreshold) {
+  auto log = options();
+  log.threshold = 0ns;
+  m_conn.setSlowQueryLog(log);
+
+  Q{R"sql(select 42)sql", m_conn}.execute();
+
+  EXPECT_THAT(output(), HasSubstr("warning slow query duration_ns="));
+  EXPECT_THAT(output(), HasSubstr("select"));
+}
+
+TEST_F(SlowQueryLogTest, fastStatementsAreSampled) {
+  auto log = options();
+  log.threshold = 1h;
+  log.sampleEvery = 2;
+  m_conn.setSlowQueryLog(log);
+
+  auto query = Q{R"sql(select 1)sql", m_conn};
+  for (auto i = 0; i < 4; ++i)
+    query.execute();
+  query.reset();
+
+  const auto text = output();
+  EXPECT_THAT(text, Not(HasSubstr("slow query")));
+  auto sampled = 0;
+  for (auto pos = text.find("sampled query"); pos != std::string::npos;
+       pos = text.find("sampled query", pos + 1))
+    ++sampled;
+  EXPECT_THAT(sampled, ::testing::Eq(2));
+}
+
+TEST_F(SlowQueryLogTest, logsStatementTextWhenAsked) {
+  auto log = options();
+  log.threshold = 1h;
+  log.logStatements = true;
+  m_conn.setSlowQueryLog(log);
+
+  Q{R"sql(select 'traced')sql", m_conn}.execute();
+
+  EXPECT_THAT(output(), HasSubstr("trace statement sql=\"select 'traced'\""));
+}
+
+TEST_F(SlowQueryLogTest, disableStopsLogging) {
+  auto log = options();
+  log.threshold = 0ns;
+  m_conn.setSlowQueryLog(log);
+  m_conn.disableSlowQueryLog();
+
+  Q{R"sql(select 42)sql", m_conn}.execute();
+
+  EXPECT_THAT(output(), ::testing::IsEmpty());
+}
+
+TEST_F(SlowQueryLogTest, queryFinishedAfterConnectionIsNotLogged) {
+  auto conn = std::optional<Database::Connection>{std::in_place};
+  auto log = options();
+  log.threshold = 0ns;
+  conn->setSlowQueryLog(log);
+  auto query = std::optional<Q>{
+      std::in_place, R"sql(select 1 union all select 2)sql", *conn};
+  query->rows().begin();
+  const auto logged = output();
+
+  conn.reset();
+  query.reset();
+
+  EXPECT_THAT(output(), ::testing::Eq(logged));
+}
+
+} // namespace
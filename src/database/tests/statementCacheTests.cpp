@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <optional>
+
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/isTableExist.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+
+class StatementCacheTest : public ::testing::Test {
+protected:
+  Database::Connection m_conn;
+};
+
+TEST_F(StatementCacheTest, sameSqlHitsCache) {
+  constexpr auto sql = R"sql(select 1 'id')sql";
+  { Q{sql, m_conn}.execute(); }
+  { Q{sql, m_conn}.execute(); }
+
+  const auto stats = m_conn.statementCacheStats();
+  EXPECT_THAT(stats.misses, ::testing::Eq(1));
+  EXPECT_THAT(stats.hits, ::testing::Eq(1));
+  EXPECT_THAT(stats.size, ::testing::Eq(1));
+}
+
+TEST_F(StatementCacheTest, optOutBypassesCache) {
+  constexpr auto sql = R"sql(select 1 'id')sql";
+  const auto options = Database::QueryOptions{false};
+  { Q(sql, m_conn, options).execute(); }
+  { Q(sql, m_conn, options).execute(); }
+
+  const auto stats = m_conn.statementCacheStats();
+  EXPECT_THAT(stats.hits, ::testing::Eq(0));
+  EXPECT_THAT(stats.misses, ::testing::Eq(0));
+  EXPECT_THAT(stats.size, ::testing::Eq(0));
+}
+
+TEST_F(StatementCacheTest, borrowedStatementIsNotShared) {
+  constexpr auto sql = R"sql(select :val 'value')sql";
+  auto first = Q{sql, m_conn};
+  auto second = Q{sql, m_conn};
+  first.set("val", 1);
+  second.set("val", 2);
+  first.execute();
+  second.execute();
+
+  EXPECT_THAT(first.get<int64_t>("value"), ::testing::Eq(1));
+  EXPECT_THAT(second.get<int64_t>("value"), ::testing::Eq(2));
+  EXPECT_THAT(m_conn.statementCacheStats().size, ::testing::Eq(1));
+}
+
+TEST_F(StatementCacheTest, returnedStatementHasBindingsCleared) {
+  constexpr auto sql = R"sql(select :val 'value')sql";
+  {
+    auto query = Q{sql, m_conn};
+    query.set("val", 1);
+    query.execute();
+  }
+
+  auto query = Q{sql, m_conn};
+  query.execute();
+  EXPECT_THAT(query.get<std::optional<int64_t>>("value"),
+              ::testing::Eq(std::nullopt));
+  EXPECT_THAT(m_conn.statementCacheStats().hits, ::testing::Eq(1));
+}
+
+TEST_F(StatementCacheTest, leastRecentlyUsedIsEvicted) {
+  m_conn.setStatementCacheCapacity(2);
+  { Q(R"sql(select 1)sql", m_conn).execute(); }
+  { Q(R"sql(select 2)sql", m_conn).execute(); }
+  { Q(R"sql(select 1)sql", m_conn).execute(); }
+  { Q(R"sql(select 3)sql", m_conn).execute(); }
+  { Q(R"sql(select 1)sql", m_conn).execute(); }
+  { Q(R"sql(select 2)sql", m_conn).execute(); }
+
+  const auto stats = m_conn.statementCacheStats();
+  EXPECT_THAT(stats.hits, ::testing::Eq(2));
+  EXPECT_THAT(stats.misses, ::testing::Eq(4));
+  EXPECT_THAT(stats.evictions, ::testing::Eq(2));
+  EXPECT_THAT(stats.size, ::testing::Eq(2));
+}
+
+TEST_F(StatementCacheTest, zeroCapacityDisablesCache) {
+  m_conn.setStatementCacheCapacity(0);
+  { Q(R"sql(select 1)sql", m_conn).execute(); }
+  { Q(R"sql(select 1)sql", m_conn).execute(); }
+
+  const auto stats = m_conn.statementCacheStats();
+  EXPECT_THAT(stats.hits, ::testing::Eq(0));
+  EXPECT_THAT(stats.size, ::testing::Eq(0));
+}
+
+TEST_F(StatementCacheTest, isTableExistReusesStatement) {
+  Database::isTableExist(m_conn, "foo");
+  Database::isTableExist(m_conn, "bar");
+
+  EXPECT_THAT(m_conn.statementCacheStats().hits, ::testing::Eq(1));
+}
+
+TEST(StatementCacheLifetimeTest, queryMayOutliveConnection) {
+  auto conn = std::optional<Database::Connection>{std::in_place};
+  auto cached = Q{R"sql(select 1 'id')sql", *conn};
+  auto uncached =
+      Q{R"sql(select 2 'id')sql", *conn, Database::QueryOptions{false}};
+
+  conn.reset();
+
+  EXPECT_NO_THROW(cached.reset());
+  EXPECT_NO_THROW(uncached.reset());
+}
+
+} // namespace
@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <string>
+
+#include "database/Connection.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "database/StatementSpec.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+
+constexpr auto echoSpec = Database::StatementSpec{
+    R"sql(select :id 'id', :payload 'payload')sql",
+    Database::names("id", "payload"), Database::names("id", "payload")};
+
+constexpr auto idParameter = echoSpec.parameter("id");
+constexpr auto payloadParameter = echoSpec.parameter("payload");
+constexpr auto idColumn = echoSpec.column("id");
+constexpr auto payloadColumn = echoSpec.column("payload");
+
+static_assert(idParameter.index == 1);
+static_assert(payloadParameter.index == 2);
+static_assert(idColumn.index == 0);
+static_assert(payloadColumn.index == 1);
+
+class StatementSpecTest : public ::testing::Test {
+protected:
+  Database::Connection m_conn;
+};
+
+TEST_F(StatementSpecTest, bindAndReadThroughHandles) {
+  auto query = Q{echoSpec, m_conn};
+  query.set(idParameter, 7);
+  query.set(payloadParameter, std::string{"data"});
+  query.execute();
+
+  EXPECT_THAT(query.get<int64_t>(idColumn), ::testing::Eq(7));
+  EXPECT_THAT(query.get<std::string>(payloadColumn), ::testing::Eq("data"));
+}
+
+TEST_F(StatementSpecTest, noParametersOrColumns) {
+  constexpr auto spec = Database::StatementSpec{
+      R"sql(create table foo (id integer))sql", Database::names(),
+      Database::names()};
+
+  Q{spec, m_conn}.execute();
+}
+
+TEST_F(StatementSpecTest, expectThrowWhenParameterOrderDiffers) {
+  constexpr auto spec = Database::StatementSpec{
+      R"sql(select :id 'id', :payload 'payload')sql",
+      Database::names("payload", "id"), Database::names("id", "payload")};
+
+  EXPECT_THROW((Q{spec, m_conn}), Database::IncorrectQuerySql);
+}
+
+TEST_F(StatementSpecTest, expectThrowWhenColumnMissing) {
+  constexpr auto spec = Database::StatementSpec{
+      R"sql(select :id 'id')sql", Database::names("id"),
+      Database::names("id", "payload")};
+
+  EXPECT_THROW((Q{spec, m_conn}), Database::IncorrectQuerySql);
+}
+
+TEST_F(StatementSpecTest, cachedStatementIsCheckedForEachSpec) {
+  { Q{echoSpec, m_conn}.execute(); }
+  { Q{echoSpec, m_conn}.execute(); }
+
+  constexpr auto swapped = Database::StatementSpec{
+      echoSpec.sql(), Database::names("id", "payload"),
+      Database::names("payload", "id")};
+  EXPECT_THROW((Q{swapped, m_conn}), Database::IncorrectQuerySql);
+  EXPECT_THAT(m_conn.statementCacheStats().hits, ::testing::Eq(2));
+}
+
+TEST_F(StatementSpecTest, runtimeLookupOfUnknownName) {
+  EXPECT_THROW(echoSpec.parameter("idd"), Database::NoSuchSqlParameter);
+  EXPECT_THROW(echoSpec.column("idd"), Database::NoSuchColumn);
+}
+
+} // namespace
@@ -0,0 +1,95 @@
+#include <string>
+
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/StatementStats.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+
+constexpr auto scanSql = R"sql(select id from session where note = ?)sql";
+
+class StatementStatsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Q{R"sql(create table session (id integer primary key, note text))sql",
+      m_conn}
+        .execute();
+    Q{R"sql(insert into session values (1, 'a'), (2, 'b'), (3, 'a'))sql",
+      m_conn}
+        .execute();
+    Database::setStatementStatsRegistry(&m_registry);
+  }
+
+  void TearDown() override { Database::setStatementStatsRegistry(nullptr); }
+
+  auto statsOf(const char *sql) -> Database::StatementStats {
+    const auto snapshot = m_registry.snapshot();
+    for (const auto &[key, stats] : snapshot)
+      if (key.find(sql) != std::string::npos)
+        return stats;
+    ADD_FAILURE() << "no stats for " << sql;
+    return {};
+  }
+
+  Database::Connection m_conn;
+  Database::StatementStatsRegistry m_registry;
+};
+
+TEST_F(StatementStatsTest, queryStatusReportsFullScan) {
+  auto query = Q{scanSql, m_conn};
+  query.bind("a");
+  while (query.next()) {
+  }
+
+  EXPECT_THAT(query.status().fullscanSteps, ::testing::Gt(0u));
+  EXPECT_THAT(query.status().vmSteps, ::testing::Gt(0u));
+}
+
+TEST_F(StatementStatsTest, runsAreAggregatedPerStatement) {
+  auto query = Q{scanSql, m_conn};
+  for (const auto note : {"a", "b", "c"}) {
+    query.bind(note);
+    while (query.next()) {
+    }
+  }
+
+  const auto stats = statsOf("where note");
+  EXPECT_THAT(stats.prepares, ::testing::Eq(1u));
+  EXPECT_THAT(stats.runs, ::testing::Eq(3u));
+  EXPECT_THAT(stats.rows, ::testing::Eq(3u));
+  // Each run scans the whole table.
+  EXPECT_THAT(stats.fullscanSteps, ::testing::Ge(3u));
+  EXPECT_THAT(stats.stepTime.count(), ::testing::Gt(0));
+}
+
+TEST_F(StatementStatsTest, abandonedRunIsRecordedOnReset) {
+  auto query = Q{R"sql(select id from session order by note)sql", m_conn};
+  query.execute();
+  query.reset();
+
+  const auto stats = statsOf("order by note");
+  EXPECT_THAT(stats.runs, ::testing::Eq(1u));
+  EXPECT_THAT(stats.rows, ::testing::Eq(1u));
+  EXPECT_THAT(stats.sorts, ::testing::Eq(1u));
+}
+
+TEST_F(StatementStatsTest, nothingIsRecordedWithoutRegistry) {
+  Database::setStatementStatsRegistry(nullptr);
+  Q{scanSql, m_conn}.execute();
+
+  EXPECT_TRUE(m_registry.snapshot().empty());
+}
+
+TEST_F(StatementStatsTest, dumpListsStatements) {
+  Q{scanSql, m_conn}.execute();
+
+  const auto dump = m_registry.dump();
+  EXPECT_THAT(dump, ::testing::HasSubstr("runs=1"));
+  EXPECT_THAT(dump, ::testing::HasSubstr("fullscan_steps="));
+}
+
+} // namespace
@@ -0,0 +1,78 @@
+#include <mutex>
+#include <vector>
+
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/Trace.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+using Database::TraceEvent;
+
+class RecordingSink : public Database::TraceSink {
+public:
+  auto record(const Database::TraceRecord &record) -> void override {
+    const auto lock = std::lock_guard{m_mutex};
+    records.push_back(record);
+  }
+
+  auto events() const -> std::vector<TraceEvent> {
+    auto result = std::vector<TraceEvent>{};
+    for (const auto &record : records)
+      result.push_back(record.event);
+    return result;
+  }
+
+  std::vector<Database::TraceRecord> records;
+
+private:
+  std::mutex m_mutex;
+};
+
+class TraceTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+#ifndef DATABASE_ENABLE_TRACING
+    GTEST_SKIP() << "built with DATABASE_ENABLE_TRACING=OFF";
+#endif
+    Database::setTraceSink(&m_sink);
+  }
+  void TearDown() override { Database::setTraceSink(nullptr); }
+
+  Database::Connection m_conn;
+  RecordingSink m_sink;
+};
+
+TEST_F(TraceTest, recordsPrepareBindAndStep) {
+  auto query = Q{R"sql(select :val 'value')sql", m_conn};
+  query.set("val", 1);
+  query.execute();
+
+  EXPECT_THAT(m_sink.events(),
+              ::testing::ElementsAre(TraceEvent::Prepare, TraceEvent::Bind,
+                                     TraceEvent::Step));
+  EXPECT_THAT(m_sink.records[0].statement, ::testing::NotNull());
+  EXPECT_THAT(m_sink.records[1].index, ::testing::Eq(1));
+  EXPECT_THAT(m_sink.records[2].resultCode, ::testing::Eq(SQLITE_ROW));
+}
+
+TEST_F(TraceTest, cachedStatementIsNotPreparedAgain) {
+  constexpr auto sql = R"sql(select 1 'value')sql";
+  { Q{sql, m_conn}.execute(); }
+  m_sink.records.clear();
+  { Q{sql, m_conn}.execute(); }
+
+  EXPECT_THAT(m_sink.events(), ::testing::ElementsAre(TraceEvent::Step));
+}
+
+TEST_F(TraceTest, nothingRecordedWithoutSink) {
+  Database::setTraceSink(nullptr);
+  Q{R"sql(select 1 'value')sql", m_conn}.execute();
+
+  EXPECT_THAT(m_sink.records, ::testing::IsEmpty());
+}
+
+} // namespace
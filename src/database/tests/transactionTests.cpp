@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <stdexcept>
+
+#include "database/Connection.h"
+#include "database/Query.h"
+#include "database/Transaction.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using Q = Database::Query;
+
+class TransactionTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Q{R"sql(create table foo (id integer))sql", m_conn}.execute();
+  }
+
+  auto insert(int id) -> void {
+    auto query = Q{R"sql(insert into foo values (:id))sql", m_conn};
+    query.set("id", id);
+    query.execute();
+  }
+
+  auto rowCount() -> int64_t {
+    auto query = Q{R"sql(select count(1) 'c' from foo)sql", m_conn};
+    query.execute();
+    return query.get<int64_t>("c");
+  }
+
+  Database::Connection m_conn;
+};
+
+TEST_F(TransactionTest, commitsOnScopeExit) {
+  {
+    auto transaction = Database::Transaction{m_conn};
+    insert(1);
+    EXPECT_TRUE(m_conn.isInTransaction());
+  }
+
+  EXPECT_FALSE(m_conn.isInTransaction());
+  EXPECT_THAT(rowCount(), ::testing::Eq(1));
+}
+
+TEST_F(TransactionTest, rollsBackOnException) {
+  try {
+    auto transaction =
+        Database::Transaction{m_conn, Database::TransactionMode::Immediate};
+    insert(1);
+    throw std::runtime_error("failure");
+  } catch (const std::runtime_error &) {
+  }
+
+  EXPECT_FALSE(m_conn.isInTransaction());
+  EXPECT_THAT(rowCount(), ::testing::Eq(0));
+}
+
+TEST_F(TransactionTest, explicitRollback) {
+  auto transaction =
+      Database::Transaction{m_conn, Database::TransactionMode::Exclusive};
+  insert(1);
+  transaction.rollback();
+
+  EXPECT_FALSE(transaction.isActive());
+  EXPECT_THAT(rowCount(), ::testing::Eq(0));
+}
+
+TEST_F(TransactionTest, beginAndCommitStatementsAreCached) {
+  { auto transaction = Database::Transaction{m_conn}; }
+  const auto before = m_conn.statementCacheStats();
+  { auto transaction = Database::Transaction{m_conn}; }
+  const auto after = m_conn.statementCacheStats();
+
+  EXPECT_THAT(after.hits - before.hits, ::testing::Eq(2));
+  EXPECT_THAT(after.misses, ::testing::Eq(before.misses));
+}
+
+TEST_F(TransactionTest, nestedSavepointRollsBackOnlyItsWork) {
+  {
+    auto transaction = Database::Transaction{m_conn};
+    insert(1);
+    {
+      auto outer = Database::Savepoint{m_conn};
+      insert(2);
+      try {
+        auto inner = Database::Savepoint{m_conn};
+        insert(3);
+        throw std::runtime_error("failure");
+      } catch (const std::runtime_error &) {
+      }
+      insert(4);
+    }
+  }
+
+  auto query = Q{R"sql(select group_concat(id) 'ids' from foo)sql", m_conn};
+  query.execute();
+  EXPECT_THAT(query.get<std::string>("ids"), ::testing::Eq("1,2,4"));
+}
+
+TEST_F(TransactionTest, savepointWithoutTransaction) {
+  {
+    auto savepoint = Database::Savepoint{m_conn};
+    insert(1);
+    EXPECT_TRUE(m_conn.isInTransaction());
+  }
+
+  EXPECT_FALSE(m_conn.isInTransaction());
+  EXPECT_THAT(rowCount(), ::testing::Eq(1));
+}
+
+TEST_F(TransactionTest, savepointExplicitRollback) {
+  auto transaction = Database::Transaction{m_conn};
+  insert(1);
+  auto savepoint = Database::Savepoint{m_conn};
+  insert(2);
+  savepoint.rollback();
+  transaction.commit();
+
+  EXPECT_THAT(rowCount(), ::testing::Eq(1));
+}
+
+} // namespace
@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "database/Connection.h"
+#include "database/Exceptions.h"
+#include "database/Query.h"
+#include "database/WriteQueue.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+using Q = Database::Query;
+using Database::Value;
+
+constexpr auto databaseFile = "writeQueue.db3";
+
+auto removeDatabase() -> void {
+  for (const auto suffix : {"", "-wal", "-shm"})
+    std::filesystem::remove(std::string{databaseFile} + suffix);
+}
+
+auto count(Database::Connection &conn) -> std::int64_t {
+  auto query = Q{R"sql(select count(1) 'c' from event)sql", conn};
+  query.execute();
+  return query.get<std::int64_t>("c");
+}
+
+constexpr auto insertSql =
+    R"sql(insert into event (id, payload) values (?, ?))sql";
+
+class WriteQueueTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    removeDatabase();
+    m_conn = std::make_unique<Database::Connection>(
+        databaseFile, Database::ConnectionOptions::highThroughput());
+    Q{R"sql(create table event (id integer primary key, payload))sql", *m_conn}
+        .execute();
+  }
+
+  void TearDown() override {
+    m_conn.reset();
+    removeDatabase();
+  }
+
+  std::unique_ptr<Database::Connection> m_conn;
+};
+
+TEST_F(WriteQueueTest, futureResolvesToChangedRows) {
+  auto queue = Database::WriteQueue{*m_conn};
+  queue.submit(insertSql, {Value{std::int64_t{1}}, Value{"a"}}).get();
+  queue.submit(insertSql, {Value{std::int64_t{2}}, Value{"b"}}).get();
+
+  auto updated =
+      queue.submit(R"sql(update event set payload = null)sql").get();
+
+  EXPECT_THAT(updated, ::testing::Eq(2));
+}
+
+TEST_F(WriteQueueTest, bindsEveryValueAlternative) {
+  {
+    auto queue = Database::WriteQueue{*m_conn};
+    queue.submit(insertSql, {Value{std::int64_t{1}}, Value{nullptr}});
+    queue.submit(insertSql, {Value{std::int64_t{2}}, Value{2.5}});
+    queue.submit(insertSql, {Value{std::int64_t{3}},
+                             Value{std::vector{std::byte{7}}}})
+        .get();
+  }
+
+  auto query = Q{R"sql(select typeof(payload) 't' from event order by id)sql",
+                 *m_conn};
+  auto types = std::vector<std::string>{};
+  for (auto &row : query.rows())
+    types.push_back(row.get<std::string>("t"));
+
+  EXPECT_THAT(types, ::testing::ElementsAre("null", "real", "blob"));
+}
+
+TEST_F(WriteQueueTest, concurrentProducersAreGroupCommitted) {
+  constexpr auto producers = 8;
+  constexpr auto jobsPerProducer = 200;
+
+  auto queue = Database::WriteQueue{*m_conn};
+  auto threads = std::vector<std::thread>{};
+  for (auto p = 0; p < producers; ++p)
+    threads.emplace_back([&queue, p] {
+      auto results = std::vector<std::future<std::int64_t>>{};
+      for (auto i = 0; i < jobsPerProducer; ++i)
+        results.push_back(queue.submit(
+            insertSql, {Value{std::int64_t{p * jobsPerProducer + i}},
+                        Value{"payload"}}));
+      for (auto &result : results)
+        EXPECT_THAT(result.get(), ::testing::Eq(1));
+    });
+  for (auto &thread : threads)
+    thread.join();
+
+  const auto stats = queue.stats();
+  EXPECT_THAT(stats.jobs, ::testing::Eq(producers * jobsPerProducer));
+  EXPECT_THAT(stats.failedJobs, ::testing::Eq(0u));
+  EXPECT_THAT(stats.commits, ::testing::Lt(stats.jobs));
+  EXPECT_THAT(count(*m_conn), ::testing::Eq(producers * jobsPerProducer));
+}
+
+TEST_F(WriteQueueTest, failingJobDoesNotAbortItsGroup) {
+  auto options = Database::WriteQueueOptions{};
+  options.maxBatchLatency = 50ms;
+  auto queue = Database::WriteQueue{*m_conn, options};
+
+  auto first = queue.submit(insertSql, {Value{std::int64_t{1}}, Value{"a"}});
+  auto duplicate =
+      queue.submit(insertSql, {Value{std::int64_t{1}}, Value{"b"}});
+  auto last = queue.submit(insertSql, {Value{std::int64_t{2}}, Value{"c"}});
+
+  EXPECT_THAT(first.get(), ::testing::Eq(1));
+  EXPECT_THROW(duplicate.get(), Database::QueryError);
+  EXPECT_THAT(last.get(), ::testing::Eq(1));
+  EXPECT_THAT(queue.stats().failedJobs, ::testing::Eq(1u));
+  EXPECT_THAT(count(*m_conn), ::testing::Eq(2));
+}
+
+TEST_F(WriteQueueTest, jobEndingTheTransactionFailsRestOfGroup) {
+  auto options = Database::WriteQueueOptions{};
+  options.maxBatchLatency = 50ms;
+  auto queue = Database::WriteQueue{*m_conn, options};
+
+  auto first = queue.submit(insertSql, {Value{std::int64_t{10}}, Value{"a"}});
+  auto rollback = queue.submit(
+      R"sql(insert or rollback into event (id, payload) values (?, ?))sql",
+      {Value{std::int64_t{10}}, Value{"b"}});
+  auto last = queue.submit(insertSql, {Value{std::int64_t{30}}, Value{"c"}});
+
+  EXPECT_THROW(first.get(), Database::DatabaseRuntimeError);
+  EXPECT_THROW(rollback.get(), Database::QueryError);
+  EXPECT_THROW(last.get(), Database::DatabaseRuntimeError);
+  EXPECT_THAT(queue.stats().failedJobs, ::testing::Eq(3u));
+  EXPECT_THAT(count(*m_conn), ::testing::Eq(0));
+  EXPECT_FALSE(m_conn->isInTransaction());
+}
+
+TEST_F(WriteQueueTest, failedBeginFailsEveryJob) {
+  auto options = Database::ConnectionOptions::highThroughput();
+  options.busyTimeout = 0ms;
+  auto writer = Database::Connection{databaseFile, options};
+  Q{"begin immediate", *m_conn}.execute();
+
+  auto results = std::vector<std::future<std::int64_t>>{};
+  {
+    auto queue = Database::WriteQueue{writer};
+    for (auto i = 0; i < 3; ++i)
+      results.push_back(
+          queue.submit(insertSql, {Value{std::int64_t{i}}, Value{nullptr}}));
+    for (auto &result : results)
+      EXPECT_THROW(result.get(), Database::QueryError);
+    EXPECT_THAT(queue.stats().failedJobs, ::testing::Eq(3u));
+  }
+
+  Q{"rollback", *m_conn}.execute();
+  EXPECT_THAT(count(*m_conn), ::testing::Eq(0));
+}
+
+TEST_F(WriteQueueTest, destructorFinishesQueuedJobs) {
+  {
+    auto queue = Database::WriteQueue{*m_conn};
+    for (auto i = 0; i < 1000; ++i)
+      queue.submit(insertSql, {Value{std::int64_t{i}}, Value{nullptr}});
+  }
+
+  EXPECT_THAT(count(*m_conn), ::testing::Eq(1000));
+  EXPECT_FALSE(m_conn->isInTransaction());
+}
+
+} // namespace